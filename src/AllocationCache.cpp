@@ -0,0 +1,33 @@
+#include "AllocationCache.h"
+
+using namespace std;
+
+
+bool AllocationCache::find(const string& key, Entry& entry)
+{
+	lock_guard<mutex> guard(lock);
+	unordered_map<string, Entry>::const_iterator found = entries.find(key);
+	if (found == entries.end())
+		return false;
+	entry = found->second;
+	return true;
+}
+
+
+void AllocationCache::insert(const string& key, Entry entry)
+{
+	lock_guard<mutex> guard(lock);
+	if (capacity == 0)
+		return;
+
+	// a function analysed by two compilations at the same time is added once
+	pair<unordered_map<string, Entry>::iterator, bool> added = entries.emplace(key, move(entry));
+	if (!added.second)
+		return;
+	order.push_back(&added.first->first);
+	if (order.size() > capacity)
+	{
+		entries.erase(entries.find(*order.front()));
+		order.pop_front();
+	}
+}
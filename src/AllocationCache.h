@@ -0,0 +1,65 @@
+#ifndef __ALLOCATION_CACHE__
+#define __ALLOCATION_CACHE__
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+#include "Constants.h"
+#include "Types.h"
+
+/**
+ * Results of the liveness analysis and resource allocation of functions, kept between compilations
+ * so that a function that didn't change since it was last compiled isn't analysed again.
+ *
+ * A function is looked up by the key of its instructions (see LivenessAnalysis), which holds
+ * everything its allocation depends on and nothing that belongs to one compilation, so a cache
+ * is created once and passed to the LivenessAnalysis of every compilation of a long-lived process.
+ * It can be used by several analyses at the same time.
+ */
+class AllocationCache
+{
+public:
+	/**
+	 * Results of the analysis of one function, its register variables are given by their positions
+	 */
+	struct Entry
+	{
+		std::vector<std::vector<int>> interferenceGraph;   // Interference graph of the register variables
+		std::vector<int> order;                            // Positions of the variables in the order they got their registers
+		std::vector<Regs> assignments;                     // Registers of the variables by their positions
+	};
+
+	/**
+	 * Constructor with paramaters
+	 * [in] capacity - number of functions whose results are kept
+	 */
+	AllocationCache(size_t capacity = ALLOCATION_CACHE_SIZE) : capacity(capacity), entries(), order(), lock() {}
+
+	AllocationCache(const AllocationCache&) = delete;
+	AllocationCache& operator=(const AllocationCache&) = delete;
+
+	/**
+	 * Looks up the results of a function
+	 * [in]  key    - key of the instructions of the function
+	 * [out] entry  - copy of the results if they were found
+	 * [out] return - boolean value if the results were found
+	 */
+	bool find(const std::string& key, Entry& entry);
+	/**
+	 * Keeps the results of a function, the oldest results are dropped if the cache is full
+	 * [in] key   - key of the instructions of the function
+	 * [in] entry - results of the analysis
+	 */
+	void insert(const std::string& key, Entry entry);
+
+private:
+	size_t capacity;                                   // Number of functions whose results are kept
+	std::unordered_map<std::string, Entry> entries;    // Results by the keys of the functions
+	std::deque<const std::string*> order;              // Keys of the entries in the order they were added
+	std::mutex lock;                                   // Lock of the entries
+};
+
+#endif
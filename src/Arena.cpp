@@ -0,0 +1,43 @@
+#include "Arena.h"
+
+#include <algorithm>
+
+using namespace std;
+
+
+void* Arena::allocate(size_t size, size_t alignment)
+{
+	int freeList = sizeClass(size);
+	if (freeList >= 0 && freeLists[freeList] != nullptr)
+	{
+		FreePiece* piece = freeLists[freeList];
+		freeLists[freeList] = piece->next;
+		return piece;
+	}
+
+	// pieces are rounded up to the alignment of the arena, so any piece of a size class fits any object of it
+	alignment = max<size_t>(alignment, ARENA_ALIGNMENT);
+	size = max<size_t>((size + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT, sizeof(FreePiece));
+	size_t offset = (blockUsed + alignment - 1) / alignment * alignment;
+	if (blocks.empty() || offset + size > blockSize)
+	{
+		blockSize = max<size_t>(ARENA_BLOCK_SIZE, size);
+		blocks.emplace_back(new max_align_t[(blockSize + sizeof(max_align_t) - 1) / sizeof(max_align_t)]);
+		offset = 0;
+	}
+
+	blockUsed = offset + size;
+	return (char*)blocks.back().get() + offset;
+}
+
+
+void Arena::deallocate(void* memory, size_t size)
+{
+	int freeList = sizeClass(size);
+	if (freeList < 0)
+		return;
+
+	FreePiece* piece = (FreePiece*)memory;
+	piece->next = freeLists[freeList];
+	freeLists[freeList] = piece;
+}
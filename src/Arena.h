@@ -0,0 +1,147 @@
+#ifndef __ARENA__
+#define __ARENA__
+
+#include <cstddef>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <type_traits>
+
+#include "Constants.h"
+
+/**
+ * Bump allocator for the objects of one compilation. Memory is taken from large blocks
+ * and given back all at once when the arena is destroyed. Small pieces that are deallocated
+ * (nodes of lists that are cleared) are kept in free lists by size and reused.
+ */
+class Arena
+{
+public:
+	Arena() : blockUsed(0), blockSize(0), freeLists() {}
+
+	Arena(const Arena&) = delete;
+	Arena& operator=(const Arena&) = delete;
+
+	/**
+	 * Returns memory for an object of the given size
+	 * [in]  size      - number of bytes
+	 * [in]  alignment - alignment of the object (at most ARENA_ALIGNMENT)
+	 * [out] return    - pointer to the memory
+	 */
+	void* allocate(size_t size, size_t alignment);
+
+	/**
+	 * Gives memory back to the arena, small pieces are reused by later allocations of the same size
+	 * [in] memory - pointer returned by allocate
+	 * [in] size   - size it was allocated with
+	 */
+	void deallocate(void* memory, size_t size);
+
+private:
+	/**
+	 * Returns the size class of a small piece of memory, -1 if it is too big for the free lists
+	 */
+	static int sizeClass(size_t size)
+	{
+		size_t rounded = (size + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT;
+		return rounded <= ARENA_FREE_LISTS ? (int)rounded - 1 : -1;
+	}
+
+	/**
+	 * Piece of memory in a free list
+	 */
+	struct FreePiece
+	{
+		FreePiece* next;
+	};
+
+	std::vector<std::unique_ptr<std::max_align_t[]>> blocks;  // Storage of the arena
+	size_t blockUsed;                                         // Bytes used in the last block
+	size_t blockSize;                                         // Size of the last block
+	FreePiece* freeLists[ARENA_FREE_LISTS];                   // Deallocated pieces by size class
+};
+
+
+/**
+ * Allocator of standard containers that takes their storage from an arena,
+ * a container that is moved into takes the arena of the moved container
+ */
+template <class T>
+class ArenaAllocator
+{
+public:
+	typedef T value_type;
+	typedef std::true_type propagate_on_container_move_assignment;
+
+	ArenaAllocator(Arena& arena) : arena(&arena) {}
+
+	template <class U>
+	ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+	T* allocate(size_t n)
+	{
+		return (T*)arena->allocate(n * sizeof(T), alignof(T));
+	}
+
+	void deallocate(T* memory, size_t n)
+	{
+		arena->deallocate(memory, n * sizeof(T));
+	}
+
+	template <class U>
+	bool operator==(const ArenaAllocator<U>& other) const
+	{
+		return arena == other.arena;
+	}
+
+	template <class U>
+	bool operator!=(const ArenaAllocator<U>& other) const
+	{
+		return arena != other.arena;
+	}
+
+private:
+	template <class U>
+	friend class ArenaAllocator;
+
+	Arena* arena;    // Arena the storage is taken from
+};
+
+
+/**
+ * Typed pool of objects in an arena. Objects of the same type are created next to each other
+ * in blocks of POOL_BLOCK_OBJECTS and are never destroyed, so they may only own memory
+ * that comes from the same arena (through ArenaAllocator).
+ */
+template <class T>
+class Pool
+{
+public:
+	Pool(Arena& arena) : arena(arena), block(nullptr), blockUsed(POOL_BLOCK_OBJECTS) {}
+
+	Pool(const Pool&) = delete;
+	Pool& operator=(const Pool&) = delete;
+
+	/**
+	 * Creates an object in the pool
+	 * [in]  args   - arguments of the constructor of the object
+	 * [out] return - pointer to the created object
+	 */
+	template <class... Args>
+	T* create(Args&&... args)
+	{
+		if (blockUsed == POOL_BLOCK_OBJECTS)
+		{
+			block = (T*)arena.allocate(sizeof(T) * POOL_BLOCK_OBJECTS, alignof(T));
+			blockUsed = 0;
+		}
+		return new (block + blockUsed++) T(std::forward<Args>(args)...);
+	}
+
+private:
+	Arena& arena;       // Arena the blocks are taken from
+	T* block;           // Block objects are currently created in
+	int blockUsed;      // Number of objects created in the current block
+};
+
+#endif
@@ -0,0 +1,189 @@
+#include "CharacterClassifier.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define CLASSIFIER_AVX2
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CLASSIFIER_SSE2
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+
+/**
+ * Index of the lowest set bit, mask must not be 0
+ */
+static inline int firstSetBit(unsigned mask)
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return (int)index;
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+
+
+#ifdef CLASSIFIER_SSE2
+
+/**
+ * Byte mask of lo <= x <= hi, bytes are compared as signed so that everything above 127 falls out
+ */
+static inline __m128i inRange(__m128i block, char lo, char hi)
+{
+	return _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8(lo - 1)), _mm_cmplt_epi8(block, _mm_set1_epi8(hi + 1)));
+}
+
+static inline __m128i isEqual(__m128i block, char c)
+{
+	return _mm_cmpeq_epi8(block, _mm_set1_epi8(c));
+}
+
+static inline unsigned supportedMask(__m128i b)
+{
+	__m128i ranges = _mm_or_si128(_mm_or_si128(inRange(b, '/', ';'), inRange(b, 'a', 'z')),
+		_mm_or_si128(inRange(b, '(', ')'), inRange(b, '\t', '\n')));
+	__m128i singles = _mm_or_si128(_mm_or_si128(isEqual(b, ','), isEqual(b, '_')),
+		_mm_or_si128(isEqual(b, '\r'), isEqual(b, ' ')));
+	return (unsigned)_mm_movemask_epi8(_mm_or_si128(ranges, singles));
+}
+
+static inline unsigned whiteSpaceMask(__m128i b)
+{
+	return (unsigned)_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(isEqual(b, ' '), isEqual(b, '\t')),
+		_mm_or_si128(isEqual(b, '\n'), isEqual(b, '\r'))));
+}
+
+static inline unsigned lineEndMask(__m128i b)
+{
+	return (unsigned)_mm_movemask_epi8(_mm_or_si128(isEqual(b, '\n'), isEqual(b, '\r')));
+}
+
+#endif
+
+#ifdef CLASSIFIER_AVX2
+
+static inline __m256i inRange(__m256i block, char lo, char hi)
+{
+	return _mm256_and_si256(_mm256_cmpgt_epi8(block, _mm256_set1_epi8(lo - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8(hi + 1), block));
+}
+
+static inline __m256i isEqual(__m256i block, char c)
+{
+	return _mm256_cmpeq_epi8(block, _mm256_set1_epi8(c));
+}
+
+static inline unsigned supportedMask(__m256i b)
+{
+	__m256i ranges = _mm256_or_si256(_mm256_or_si256(inRange(b, '/', ';'), inRange(b, 'a', 'z')),
+		_mm256_or_si256(inRange(b, '(', ')'), inRange(b, '\t', '\n')));
+	__m256i singles = _mm256_or_si256(_mm256_or_si256(isEqual(b, ','), isEqual(b, '_')),
+		_mm256_or_si256(isEqual(b, '\r'), isEqual(b, ' ')));
+	return (unsigned)_mm256_movemask_epi8(_mm256_or_si256(ranges, singles));
+}
+
+static inline unsigned whiteSpaceMask(__m256i b)
+{
+	return (unsigned)_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(isEqual(b, ' '), isEqual(b, '\t')),
+		_mm256_or_si256(isEqual(b, '\n'), isEqual(b, '\r'))));
+}
+
+static inline unsigned lineEndMask(__m256i b)
+{
+	return (unsigned)_mm256_movemask_epi8(_mm256_or_si256(isEqual(b, '\n'), isEqual(b, '\r')));
+}
+
+#endif
+
+
+/**
+ * Stop conditions for findFirst. Each one gives the mask of stopping bytes in a vector block
+ * (bit i set when byte i stops the search) and the same test for a single byte.
+ */
+struct UnsupportedStop
+{
+#ifdef CLASSIFIER_SSE2
+	static unsigned mask(__m128i block) { return ~supportedMask(block) & 0xFFFF; }
+#endif
+#ifdef CLASSIFIER_AVX2
+	static unsigned mask(__m256i block) { return ~supportedMask(block); }
+#endif
+	static bool test(unsigned char c) { return !CharacterClassifier::isSupported(c); }
+};
+
+struct NonWhiteSpaceStop
+{
+#ifdef CLASSIFIER_SSE2
+	static unsigned mask(__m128i block) { return ~whiteSpaceMask(block) & 0xFFFF; }
+#endif
+#ifdef CLASSIFIER_AVX2
+	static unsigned mask(__m256i block) { return ~whiteSpaceMask(block); }
+#endif
+	static bool test(unsigned char c) { return !CharacterClassifier::isWhiteSpace(c); }
+};
+
+struct LineEndStop
+{
+#ifdef CLASSIFIER_SSE2
+	static unsigned mask(__m128i block) { return lineEndMask(block); }
+#endif
+#ifdef CLASSIFIER_AVX2
+	static unsigned mask(__m256i block) { return lineEndMask(block); }
+#endif
+	static bool test(unsigned char c) { return c == '\n' || c == '\r'; }
+};
+
+
+/**
+ * Returns the first position in [cursor, limit) on which Stop says to stop, limit if there is none
+ */
+template <class Stop>
+static const char* findFirst(const char* cursor, const char* limit)
+{
+#ifdef CLASSIFIER_AVX2
+	for (; limit - cursor >= 32; cursor += 32)
+	{
+		unsigned mask = Stop::mask(_mm256_loadu_si256((const __m256i*)cursor));
+		if (mask != 0)
+			return cursor + firstSetBit(mask);
+	}
+#endif
+#ifdef CLASSIFIER_SSE2
+	for (; limit - cursor >= 16; cursor += 16)
+	{
+		unsigned mask = Stop::mask(_mm_loadu_si128((const __m128i*)cursor));
+		if (mask != 0)
+			return cursor + firstSetBit(mask);
+	}
+#endif
+	for (; cursor != limit; cursor++)
+	{
+		if (Stop::test((unsigned char)*cursor))
+			return cursor;
+	}
+	return limit;
+}
+
+
+const char* CharacterClassifier::findUnsupported(const char* cursor, const char* limit)
+{
+	return findFirst<UnsupportedStop>(cursor, limit);
+}
+
+
+const char* CharacterClassifier::skipWhiteSpace(const char* cursor, const char* limit)
+{
+	return findFirst<NonWhiteSpaceStop>(cursor, limit);
+}
+
+
+const char* CharacterClassifier::findLineEnd(const char* cursor, const char* limit)
+{
+	return findFirst<LineEndStop>(cursor, limit);
+}
@@ -0,0 +1,51 @@
+#ifndef __CHARACTER_CLASSIFIER__
+#define __CHARACTER_CLASSIFIER__
+
+/**
+ * Block-wise character classification used by the lexer before the FSM runs.
+ * Every method classifies 16 (SSE2) or 32 (AVX2) bytes at a time where the target supports it
+ * and falls back to a byte loop for the tail of the buffer and on other targets.
+ */
+class CharacterClassifier
+{
+public:
+	/**
+	 * Returns true if the byte is one of FiniteStateMachine's supportedCharacters.
+	 * The vector code tests the same ranges, FiniteStateMachine.cpp checks that they stay in sync.
+	 */
+	static constexpr bool isSupported(unsigned char c)
+	{
+		return (c >= '/' && c <= ';')		// / 0..9 : ;
+			|| (c >= 'a' && c <= 'z')
+			|| (c >= '(' && c <= ')')
+			|| (c >= '\t' && c <= '\n')
+			|| c == ',' || c == '_' || c == '\r' || c == ' ';
+	}
+
+	/**
+	 * Returns true for characters the FSM reads as white space (state 08)
+	 */
+	static constexpr bool isWhiteSpace(unsigned char c)
+	{
+		return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+	}
+
+	/**
+	 * Returns the position of the first byte in [cursor, limit) that is not a supported character,
+	 * limit if there is none
+	 */
+	static const char* findUnsupported(const char* cursor, const char* limit);
+
+	/**
+	 * Returns the position of the first byte in [cursor, limit) that is not white space
+	 */
+	static const char* skipWhiteSpace(const char* cursor, const char* limit);
+
+	/**
+	 * Returns the position of the first line end ('\n' or '\r') in [cursor, limit).
+	 * On input that passed findUnsupported this is the end of a comment body.
+	 */
+	static const char* findLineEnd(const char* cursor, const char* limit);
+};
+
+#endif
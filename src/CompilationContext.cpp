@@ -0,0 +1,50 @@
+#include "CompilationContext.h"
+
+using namespace std;
+
+
+CompilationContext::CompilationContext() :
+	symbols(), arena(), variablePool(arena), variables(), variableCounter(0), parts() {}
+
+
+SymbolTable& CompilationContext::getSymbols()
+{
+	return symbols;
+}
+
+
+Arena& CompilationContext::getArena()
+{
+	return arena;
+}
+
+
+Pool<Variable>& CompilationContext::getVariablePool()
+{
+	return variablePool;
+}
+
+
+int CompilationContext::addVariable(Variable* var)
+{
+	variables.push_back(var);
+	return (int)variables.size() - 1;
+}
+
+
+Variable* CompilationContext::getVariable(int id)
+{
+	return variables[id];
+}
+
+
+int CompilationContext::nextVariablePosition()
+{
+	return variableCounter++;
+}
+
+
+void CompilationContext::adopt(unique_ptr<CompilationContext> part)
+{
+	parts.push_back(move(part));
+}
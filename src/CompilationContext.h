@@ -0,0 +1,76 @@
+#ifndef __COMPILATION_CONTEXT__
+#define __COMPILATION_CONTEXT__
+
+#include <vector>
+#include <memory>
+
+#include "SymbolTable.h"
+#include "Arena.h"
+
+class Variable;
+
+/**
+ * State of one compilation, shared by all of its phases: the names of identifiers, the storage
+ * of variables and their lists, the table of variables by their ids and the counter that gives
+ * register variables their positions.
+ * Nothing is shared between contexts, so compilations with different contexts can follow each
+ * other in one process or run at the same time on different threads. A context is used by one
+ * thread at a time and has to outlive the phases that use it.
+ */
+class CompilationContext
+{
+public:
+	CompilationContext();
+
+	CompilationContext(const CompilationContext&) = delete;
+	CompilationContext& operator=(const CompilationContext&) = delete;
+
+	/**
+	 * Returns the names of identifiers read in the compilation
+	 */
+	SymbolTable& getSymbols();
+	/**
+	 * Returns the arena lists of variables take their nodes from
+	 */
+	Arena& getArena();
+	/**
+	 * Returns the pool variables are created in
+	 */
+	Pool<Variable>& getVariablePool();
+
+	/**
+	 * Adds a variable to the table of variables of the compilation
+	 * [in]  var    - variable
+	 * [out] return - id of the variable, its index in the table
+	 */
+	int addVariable(Variable* var);
+	/**
+	 * Returns the variable with the given id
+	 * [in]  id     - id of the variable
+	 * [out] return - pointer to the variable
+	 */
+	Variable* getVariable(int id);
+
+	/**
+	 * Returns the position of the next register variable in the interference matrix
+	 * [out] return - number of register variables created so far
+	 */
+	int nextVariablePosition();
+
+	/**
+	 * Keeps the context of a separately compiled part alive as long as this one,
+	 * so that its variables can be used by this compilation
+	 * [in] part - context of the part
+	 */
+	void adopt(std::unique_ptr<CompilationContext> part);
+
+private:
+	SymbolTable symbols;                                   // Names of identifiers
+	Arena arena;                                           // Storage of the compilation (freed all at once)
+	Pool<Variable> variablePool;                           // Variables, next to each other in the arena
+	std::vector<Variable*> variables;                      // Variables by their ids
+	int variableCounter;                                   // Number of register variables created
+	std::vector<std::unique_ptr<CompilationContext>> parts; // Contexts of the parts merged into this one
+};
+
+#endif
@@ -8,16 +8,121 @@ const int IDLE_STATE = 0;
 const int START_STATE = 1;
 const int INVALID_STATE = -2;
 
+/**
+ * States the lexer enters without running the FSM
+ */
+const int WHITE_SPACE_STATE = 8;
+const int COMMENT_STATE = 15;
+
+/**
+ * States whose lexeme may be a reserved word
+ */
+const int RESERVED_WORD_STATE = 9;
+const int IDENTIFIER_STATE = 10;
+
+/**
+ * State whose lexeme is a number
+ */
+const int NUMBER_STATE = 2;
+
 /**
  * Number of states in FSM
  */
-const int NUM_STATES = 52;
+const int NUM_STATES = 16;
 
 /**
  * Number of supported characters
  */
 const int NUM_OF_CHARACTERS = 47;
 
+/**
+ * Number of reserved words and size of the hash table they are looked up in (power of two)
+ */
+const int NUM_OF_KEYWORDS = 17;
+const int KEYWORD_TABLE_SIZE = 64;
+
+/**
+ * Number of instruction types and the most punctuation tokens and operands an instruction is read from
+ */
+const int NUM_OF_INSTRUCTIONS = 15;
+const int MAX_INSTRUCTION_STEPS = 8;
+
+/**
+ * Most operands an instruction has, the size of the operands of an instruction record
+ */
+const int MAX_OPERANDS = 3;
+
+/**
+ * Number of characters allocated at once for storing identifier names
+ */
+const int SYMBOL_BLOCK_SIZE = 16 * 1024;
+
+/**
+ * Size of the blocks of memory of an arena, alignment of the pieces it gives out, number of
+ * size classes of deallocated pieces kept for reuse and number of objects in a block of a pool
+ */
+const int ARENA_BLOCK_SIZE = 64 * 1024;
+const int ARENA_ALIGNMENT = 8;
+const int ARENA_FREE_LISTS = 8;
+const int POOL_BLOCK_OBJECTS = 256;
+
+/**
+ * Symbol of tokens and variables that don't have a name in the symbol table
+ */
+const unsigned NO_SYMBOL = 0xFFFFFFFF;
+
+/**
+ * Longest token value the lexical analysis keeps - only a comment can be longer,
+ * and then only its start is kept
+ */
+const unsigned MAX_TOKEN_LENGTH = (1 << 24) - 1;
+
+/**
+ * Number of tokens read before the token stream estimates how many tokens the whole source has
+ */
+const unsigned TOKEN_SAMPLE_SIZE = 4096;
+
+/**
+ * Number of distinct input bytes (columns of the dense transition table)
+ */
+const int NUM_OF_BYTES = 256;
+
+/**
+ * Size of the window kept of an input that is streamed instead of memory mapped
+ */
+const int STREAM_BUFFER_SIZE = 64 * 1024;
+
+/**
+ * Number of input bytes checked against supported characters in one go
+ */
+const int VALIDATION_CHUNK_SIZE = 64 * 1024;
+
+/**
+ * Number of tokens syntax analysis can look ahead when pulling tokens from the lexer
+ * (size of the lookahead ring, power of two)
+ */
+const int TOKEN_LOOKAHEAD = 4;
+
+/**
+ * Smallest part of a program that is parsed on its own thread by SyntaxAnalysis::DoParallel
+ */
+const int PARALLEL_PARSE_CHUNK_SIZE = 1024 * 1024;
+
+/**
+ * Version of the module files written by separate compilation, modules of other versions are compiled again
+ */
+const int MODULE_VERSION = 1;
+
+/**
+ * Version of the binary IR images written after syntax analysis, images of other versions aren't loaded
+ */
+const unsigned IR_IMAGE_VERSION = 1;
+
+/**
+ * Number of functions whose allocation results an AllocationCache keeps, the oldest ones are dropped first
+ */
+const int ALLOCATION_CACHE_SIZE = 4096;
+
 /**
  * Use this when instruction interference to other instruction.
  */
@@ -0,0 +1,222 @@
+/**
+ * GENERATED by tools/ScannerGenerator.cpp from FiniteStateMachine, do not edit by hand.
+ */
+
+#include "DirectScanner.h"
+
+
+const char* DirectScanner::scan(const char* cursor, const char* limit, int& lastFiniteState)
+{
+	const char* marker = cursor;
+	lastFiniteState = IDLE_STATE;
+
+	if (cursor == limit)
+		return marker;
+	switch ((unsigned char)*cursor++)
+	{
+		case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7':
+		case '8': case '9':
+			goto state02;
+		case ',':
+			goto state03;
+		case '(':
+			goto state04;
+		case ')':
+			goto state05;
+		case ':':
+			goto state06;
+		case ';':
+			goto state07;
+		case '\t': case '\n': case '\r': case ' ':
+			goto state08;
+		case '_':
+			goto state09;
+		case 'a': case 'b': case 'c': case 'd': case 'e': case 'f': case 'g': case 'h':
+		case 'i': case 'j': case 'k': case 'l': case 'n': case 'o': case 'p': case 'q':
+		case 's': case 't': case 'u': case 'v': case 'w': case 'x': case 'y': case 'z':
+			goto state10;
+		case 'm':
+			goto state11;
+		case 'r':
+			goto state12;
+		case '/':
+			goto state14;
+		default:
+			return marker;
+	}
+
+state02:
+	lastFiniteState = 2;
+	marker = cursor;
+	if (cursor == limit)
+		return marker;
+	switch ((unsigned char)*cursor++)
+	{
+		case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7':
+		case '8': case '9':
+			goto state02;
+		case '_': case 'a': case 'b': case 'c': case 'd': case 'e': case 'f': case 'g':
+		case 'h': case 'i': case 'j': case 'k': case 'l': case 'm': case 'n': case 'o':
+		case 'p': case 'q': case 'r': case 's': case 't': case 'u': case 'v': case 'w':
+		case 'x': case 'y': case 'z':
+			goto state13;
+		default:
+			return marker;
+	}
+
+state03:
+	lastFiniteState = 3;
+	marker = cursor;
+	return marker;
+
+state04:
+	lastFiniteState = 4;
+	marker = cursor;
+	return marker;
+
+state05:
+	lastFiniteState = 5;
+	marker = cursor;
+	return marker;
+
+state06:
+	lastFiniteState = 6;
+	marker = cursor;
+	return marker;
+
+state07:
+	lastFiniteState = 7;
+	marker = cursor;
+	return marker;
+
+state08:
+	lastFiniteState = 8;
+	marker = cursor;
+	if (cursor == limit)
+		return marker;
+	switch ((unsigned char)*cursor++)
+	{
+		case '\t': case '\n': case '\r': case ' ':
+			goto state08;
+		default:
+			return marker;
+	}
+
+state09:
+	lastFiniteState = 9;
+	marker = cursor;
+	if (cursor == limit)
+		return marker;
+	switch ((unsigned char)*cursor++)
+	{
+		case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7':
+		case '8': case '9': case '_': case 'a': case 'b': case 'c': case 'd': case 'e':
+		case 'f': case 'g': case 'h': case 'i': case 'j': case 'k': case 'l': case 'm':
+		case 'n': case 'o': case 'p': case 'q': case 'r': case 's': case 't': case 'u':
+		case 'v': case 'w': case 'x': case 'y': case 'z':
+			goto state09;
+		case '(': case ')': case ',': case '/': case ':': case ';':
+			goto state13;
+		default:
+			return marker;
+	}
+
+state10:
+	lastFiniteState = 10;
+	marker = cursor;
+	if (cursor == limit)
+		return marker;
+	switch ((unsigned char)*cursor++)
+	{
+		case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7':
+		case '8': case '9': case '_': case 'a': case 'b': case 'c': case 'd': case 'e':
+		case 'f': case 'g': case 'h': case 'i': case 'j': case 'k': case 'l': case 'm':
+		case 'n': case 'o': case 'p': case 'q': case 'r': case 's': case 't': case 'u':
+		case 'v': case 'w': case 'x': case 'y': case 'z':
+			goto state10;
+		default:
+			return marker;
+	}
+
+state11:
+	lastFiniteState = 11;
+	marker = cursor;
+	if (cursor == limit)
+		return marker;
+	switch ((unsigned char)*cursor++)
+	{
+		case '_': case 'a': case 'b': case 'c': case 'd': case 'e': case 'f': case 'g':
+		case 'h': case 'i': case 'j': case 'k': case 'l': case 'm': case 'n': case 'o':
+		case 'p': case 'q': case 'r': case 's': case 't': case 'u': case 'v': case 'w':
+		case 'x': case 'y': case 'z':
+			goto state10;
+		case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7':
+		case '8': case '9':
+			goto state11;
+		default:
+			return marker;
+	}
+
+state12:
+	lastFiniteState = 12;
+	marker = cursor;
+	if (cursor == limit)
+		return marker;
+	switch ((unsigned char)*cursor++)
+	{
+		case '_': case 'a': case 'b': case 'c': case 'd': case 'e': case 'f': case 'g':
+		case 'h': case 'i': case 'j': case 'k': case 'l': case 'm': case 'n': case 'o':
+		case 'p': case 'q': case 'r': case 's': case 't': case 'u': case 'v': case 'w':
+		case 'x': case 'y': case 'z':
+			goto state10;
+		case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7':
+		case '8': case '9':
+			goto state12;
+		default:
+			return marker;
+	}
+
+state14:
+	lastFiniteState = 14;
+	marker = cursor;
+	if (cursor == limit)
+		return marker;
+	switch ((unsigned char)*cursor++)
+	{
+		case '\t': case '\n': case '\r': case ' ': case '(': case ')': case ',': case '0':
+		case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8':
+		case '9': case ':': case ';': case '_': case 'a': case 'b': case 'c': case 'd':
+		case 'e': case 'f': case 'g': case 'h': case 'i': case 'j': case 'k': case 'l':
+		case 'm': case 'n': case 'o': case 'p': case 'q': case 'r': case 's': case 't':
+		case 'u': case 'v': case 'w': case 'x': case 'y': case 'z':
+			goto state13;
+		case '/':
+			goto state15;
+		default:
+			return marker;
+	}
+
+state13:
+	lastFiniteState = 13;
+	marker = cursor;
+	return marker;
+
+state15:
+	lastFiniteState = 15;
+	marker = cursor;
+	if (cursor == limit)
+		return marker;
+	switch ((unsigned char)*cursor++)
+	{
+		case '\t': case ' ': case '(': case ')': case ',': case '/': case '0': case '1':
+		case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9':
+		case ':': case ';': case '_': case 'a': case 'b': case 'c': case 'd': case 'e':
+		case 'f': case 'g': case 'h': case 'i': case 'j': case 'k': case 'l': case 'm':
+		case 'n': case 'o': case 'p': case 'q': case 'r': case 's': case 't': case 'u':
+		case 'v': case 'w': case 'x': case 'y': case 'z':
+			goto state15;
+		default:
+			return marker;
+	}
+
+}
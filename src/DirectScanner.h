@@ -0,0 +1,30 @@
+#ifndef __DIRECT_SCANNER__
+#define __DIRECT_SCANNER__
+
+#include "Constants.h"
+
+/**
+ * Direct-coded version of the lexical FSM. Every state of FiniteStateMachine::stateMatrix is a
+ * labelled block that switches on the next character and jumps straight to the next state.
+ *
+ * DirectScanner.cpp is generated by tools/ScannerGenerator.cpp and must not be edited by hand,
+ * regenerate it whenever stateMatrix, supportedCharacters or stateToTokenTable change.
+ * The pre-build event of the project fails when the file is out of date or when the two scanners
+ * disagree over the examples (ScannerGenerator --check).
+ * The scanner is used by LexicalAnalysis when DIRECT_CODED_SCANNER is defined, otherwise the
+ * table-driven FiniteStateMachine::scan is used (and remains the reference implementation).
+ */
+class DirectScanner
+{
+public:
+	/**
+	 * Same contract as FiniteStateMachine::scan
+	 * [in]  cursor          - first character of the token
+	 * [in]  limit           - end of the program buffer
+	 * [out] lastFiniteState - last state reached, IDLE_STATE if no character was accepted
+	 * [out] return          - position after the last accepted character
+	 */
+	static const char* scan(const char* cursor, const char* limit, int& lastFiniteState);
+};
+
+#endif
@@ -1,13 +1,32 @@
 #ifndef __FINITE_STATE_MACHINE__
 #define __FINITE_STATE_MACHINE__
 
-#include <map>
 #include <string>
+#include <stdexcept>
 
 #include "Constants.h"
 #include "Types.h"
 
-typedef std::map<int, std::map<char,int>> StateMachine;
+/**
+ * Dense transition table indexed directly by state number and input byte:
+ *		stateMachine.next[StateNumber][(unsigned char)TransitionCharacter] -> NextStateNumber
+ * Bytes that are not in supportedCharacters map to INVALID_STATE.
+ */
+struct StateMachine
+{
+	signed char next[NUM_STATES][NUM_OF_BYTES];
+};
+
+static_assert(NUM_STATES <= 127, "State numbers must fit into the signed char transition table");
+
+/**
+ * Maps every input byte to its column in stateMatrix (its character class).
+ * Unsupported bytes map to the extra class NUM_OF_CHARACTERS.
+ */
+struct ByteClasses
+{
+	unsigned char column[NUM_OF_BYTES];
+};
 
 class FiniteStateMachine
 {
@@ -15,28 +34,68 @@ public:
 	/**
 	 * Returns the next state number, based on current state and transition letter
 	 */
-	int getNextState(int currentState, char transitionLetter);
+	static int getNextState(int currentState, char transitionLetter)
+	{
+		if ((unsigned)currentState >= (unsigned)NUM_STATES)
+			throwInvalidState(currentState);
+
+		return stateMachine.next[currentState][(unsigned char)transitionLetter];
+	}
 
 	/**
-	 * Call this function to initialize FSM.
-	 * This function must be called before getNextLexToken function.
+	 * Returns the character class (stateMatrix column) of the given byte
 	 */
-	void initStateMachine();
+	static int getCharacterClass(char letter)
+	{
+		return byteClasses.column[(unsigned char)letter];
+	}
+
+	/**
+	 * Runs the FSM from START_STATE over [cursor, limit) and stops at the first transition
+	 * into IDLE_STATE or INVALID_STATE (the longest match).
+	 * [in]  cursor          - first character of the token
+	 * [in]  limit           - end of the program buffer
+	 * [out] lastFiniteState - last state reached, IDLE_STATE if no character was accepted
+	 * [out] return          - position after the last accepted character
+	 */
+	static const char* scan(const char* cursor, const char* limit, int& lastFiniteState);
 
 	/**
 	 * Get token type from the number of the state
 	 */
 	static TokenType getTokenType(int stateNumber);
 
+	/**
+	 * Checks that CharacterClassifier's character sets agree with the state matrix (evaluated at compile time)
+	 */
+	static constexpr bool classifierMatchesStateMatrix();
+
 private:
 	/**
-	 * State machine map, containing possible FSM states and transition matrix as an inner map
-	 *		map<StateNumber, map<TransitionCharacter, NextStateNumber>>
-	 * map1 key:		state number
-	 * map1 value:	map2 key -> next letter in the stream, identifies the transition to the next state
-	 *				map2 value -> next state number
+	 * Reports a state number outside of the state matrix
+	 */
+	[[noreturn]] static void throwInvalidState(int currentState);
+
+	/**
+	 * Builds byteClasses from supportedCharacters (evaluated at compile time)
+	 */
+	static constexpr ByteClasses buildByteClasses();
+
+	/**
+	 * Builds stateMachine from stateMatrix and byteClasses (evaluated at compile time)
+	 */
+	static constexpr StateMachine buildStateMachine();
+
+	/**
+	 * Transition table with one column per possible input byte, so that every transition
+	 * is a single indexed load. Generated at compile time from stateMatrix and supportedCharacters.
+	 */
+	static const StateMachine stateMachine;
+
+	/**
+	 * Character class of every possible input byte
 	 */
-	StateMachine stateMachine;
+	static const ByteClasses byteClasses;
 
 	/**
 	 * Table used for mapping states to tokens
@@ -52,8 +111,8 @@ private:
 	 * State transition matrix:
 	 *	Rows represent current state and columns the next state
 	 *	Transition characters (symbols) for each transition are defined with supportedCharacters array
-	 *	Since there are more than 10 states we introduced A-M states which are defined as numbers 
-	 *	from 10-22 for easier understanding of the matrix
+	 *	Reserved words are read as identifiers (RESERVED_WORD_STATE for the ones starting with '_')
+	 *	and recognized afterwards with Keywords
 	 *
 	 *	Example:
 	 *		row [1] -> state 1 will change to state D if the next character is 0..9
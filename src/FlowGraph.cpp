@@ -0,0 +1,334 @@
+#include "FlowGraph.h"
+
+#include <algorithm>
+
+using namespace std;
+
+
+FlowGraph::FlowGraph(CompilationContext& context, Instructions& code, int begin, int end, vector<Variable*>& regs,
+	const vector<int>& labels) :
+	context(context), code(code), begin(begin), size(end - begin), regs(regs), labels(labels), words(((int)regs.size() + 63) / 64),
+	succBegin(), succs(), predBegin(), preds(), useBegin(), uses(), defBegin(), defs(),
+	liveIn((size_t)size * words, 0), liveOut((size_t)size * words, 0), blockBegin(), blockSuccBegin(), blockSuccs(),
+	blockPredBegin(), blockPreds(), blockUse(), blockDef(), blockIn(), blockOut() {}
+
+
+/**
+ * Returns if the variable at the given position is in the set
+ */
+static bool hasVariable(const uint64_t* set, int position)
+{
+	return (set[position / 64] >> (position % 64) & 1) != 0;
+}
+/**
+ * Adds the variable at the given position to the set
+ */
+static void addVariable(uint64_t* set, int position)
+{
+	set[position / 64] |= (uint64_t)1 << (position % 64);
+}
+/**
+ * Removes the variable at the given position from the set
+ */
+static void removeVariable(uint64_t* set, int position)
+{
+	set[position / 64] &= ~((uint64_t)1 << (position % 64));
+}
+
+
+void FlowGraph::setPredAndSucc()
+{
+	vector<pair<int, int>> edges;
+	auto addEdge = [&edges](int from, int to)
+	{
+		// a branch to the next instruction gives the same edge twice, one after the other
+		if (edges.empty() || edges.back() != make_pair(from, to))
+			edges.emplace_back(from, to);
+	};
+
+	bool shouldAddToNext = true; // false after a jump/branch without a condition, the next instruction isn't its successor
+	for (int i = 1; i < size; ++i)
+	{
+		if (!code[begin + i - 1].isFunc() && shouldAddToNext)
+			addEdge(i - 1, i);
+		shouldAddToNext = true;
+
+		const InstructionDescriptor& descriptor = InstructionSet::get(code[begin + i].getType());
+		if (descriptor.branch == NO_BRANCH)
+			continue;
+		if (descriptor.branch == UNCONDITIONAL_BRANCH)
+			shouldAddToNext = false;
+
+		// a label of another function (or not defined in a module) isn't in the range of the function
+		int label = code[begin + i].getTarget();
+		int target = label < (int)labels.size() ? labels[label] - begin : -1;
+		if (target < 0 || target >= size)
+			continue;
+		if (code[begin + target].isFunc())
+			++target;
+		if (target < size)
+			addEdge(i, target);
+	}
+
+	sortEdges(edges, size, false, succBegin, succs);
+	sortEdges(edges, size, true, predBegin, preds);
+}
+
+
+void FlowGraph::sortEdges(const vector<pair<int, int>>& edges, int nodes, bool reverse, vector<int>& first, vector<int>& other)
+{
+	first.assign(nodes + 1, 0);
+	for (const pair<int, int>& edge : edges)
+		++first[(reverse ? edge.second : edge.first) + 1];
+	for (int i = 0; i < nodes; ++i)
+		first[i + 1] += first[i];
+
+	vector<int> next(first.begin(), first.end() - 1);
+	other.resize(edges.size());
+	for (const pair<int, int>& edge : edges)
+		if (reverse)
+			other[next[edge.second]++] = edge.first;
+		else
+			other[next[edge.first]++] = edge.second;
+}
+
+
+void FlowGraph::setUseAndDef()
+{
+	useBegin.assign(1, 0);
+	defBegin.assign(1, 0);
+	for (int i = 0; i < size; ++i)
+	{
+		Instruction& instruction = code[begin + i];
+		for (int o = 0; o < instruction.getNumOfOperands(); ++o)
+		{
+			OperandKind kind = instruction.getOperandKind(o);
+			if (kind != O_SRC && kind != O_DST)
+				continue;
+
+			// a variable is used or defined once even if it is written twice
+			vector<int>& vars = kind == O_SRC ? uses : defs;
+			int first = kind == O_SRC ? useBegin.back() : defBegin.back();
+			int position = context.getVariable(instruction.getOperand(o))->getPos();
+			if (find(vars.begin() + first, vars.end(), position) == vars.end())
+				vars.push_back(position);
+		}
+		useBegin.push_back((int)uses.size());
+		defBegin.push_back((int)defs.size());
+	}
+}
+
+
+void FlowGraph::setBlocks()
+{
+	// a block starts at the label of the function, the instruction after it, a label and after a branch,
+	// so only the last instruction of a block has successors outside of it
+	vector<int> blockOf(size);
+	blockBegin.clear();
+	for (int i = 0; i < size; ++i)
+	{
+		if (i <= 1 || code[begin + i].getLabel() != NO_VARIABLE ||
+			InstructionSet::get(code[begin + i - 1].getType()).branch != NO_BRANCH)
+			blockBegin.push_back(i);
+		blockOf[i] = (int)blockBegin.size() - 1;
+	}
+	int blocks = (int)blockBegin.size();
+	blockBegin.push_back(size);
+
+	vector<pair<int, int>> edges;
+	for (int b = 0; b < blocks; ++b)
+	{
+		int last = blockBegin[b + 1] - 1;
+		for (int s = succBegin[last]; s < succBegin[last + 1]; ++s)
+			edges.emplace_back(b, blockOf[succs[s]]);
+	}
+	sortEdges(edges, blocks, false, blockSuccBegin, blockSuccs);
+	sortEdges(edges, blocks, true, blockPredBegin, blockPreds);
+
+	// going backwards, a variable used by an instruction is used by the block unless an instruction before defines it
+	blockUse.assign((size_t)blocks * words, 0);
+	blockDef.assign((size_t)blocks * words, 0);
+	blockIn.assign((size_t)blocks * words, 0);
+	blockOut.assign((size_t)blocks * words, 0);
+	for (int b = 0; b < blocks; ++b)
+	{
+		Word* use = blockUse.data() + (size_t)b * words;
+		Word* def = blockDef.data() + (size_t)b * words;
+		for (int i = blockBegin[b + 1] - 1; i >= blockBegin[b]; --i)
+		{
+			for (int d = defBegin[i]; d < defBegin[i + 1]; ++d)
+			{
+				removeVariable(use, defs[d]);
+				addVariable(def, defs[d]);
+			}
+			for (int u = useBegin[i]; u < useBegin[i + 1]; ++u)
+				addVariable(use, uses[u]);
+		}
+	}
+}
+
+
+bool FlowGraph::iterate()
+{
+	bool changed = false;
+	vector<Word> set(words);
+	for (int b = (int)blockBegin.size() - 2; b >= 0; --b)
+	{
+		bool inChanged;
+		if (updateBlock(b, set, inChanged))
+			changed = true;
+	}
+	return changed;
+}
+
+
+void FlowGraph::solve()
+{
+	// a block is analysed again only when the input of one of its successors changes,
+	// the blocks are taken from the last one, as in an iteration
+	int blocks = (int)blockBegin.size() - 1;
+	vector<int> worklist(blocks);
+	vector<bool> queued(blocks, true);
+	for (int b = 0; b < blocks; ++b)
+		worklist[b] = b;
+
+	vector<Word> set(words);
+	while (!worklist.empty())
+	{
+		int b = worklist.back();
+		worklist.pop_back();
+		queued[b] = false;
+
+		bool inChanged;
+		updateBlock(b, set, inChanged);
+		if (!inChanged)
+			continue;
+		for (int p = blockPredBegin[b]; p < blockPredBegin[b + 1]; ++p)
+			if (!queued[blockPreds[p]])
+			{
+				queued[blockPreds[p]] = true;
+				worklist.push_back(blockPreds[p]);
+			}
+	}
+}
+
+
+bool FlowGraph::updateBlock(int b, vector<Word>& set, bool& inChanged)
+{
+	// out is the union of the inputs of the successors
+	bool changed = false;
+	fill(set.begin(), set.end(), 0);
+	for (int s = blockSuccBegin[b]; s < blockSuccBegin[b + 1]; ++s)
+		for (int w = 0; w < words; ++w)
+			set[w] |= blockIn[(size_t)blockSuccs[s] * words + w];
+	Word* o = blockOut.data() + (size_t)b * words;
+	if (!equal(set.begin(), set.end(), o))
+	{
+		changed = true;
+		copy(set.begin(), set.end(), o);
+	}
+
+	// in is out without the variables defined in the block with the variables it uses before defining them
+	for (int w = 0; w < words; ++w)
+		set[w] = blockUse[(size_t)b * words + w] | (set[w] & ~blockDef[(size_t)b * words + w]);
+	Word* n = blockIn.data() + (size_t)b * words;
+	inChanged = !equal(set.begin(), set.end(), n);
+	if (inChanged)
+	{
+		changed = true;
+		copy(set.begin(), set.end(), n);
+	}
+	return changed;
+}
+
+
+void FlowGraph::setLiveVariables()
+{
+	vector<Word> set(words);
+	for (int b = 0; b + 1 < (int)blockBegin.size(); ++b)
+	{
+		// the last instruction of a block has the successors of the block, the others the next instruction
+		copy(blockOut.begin() + (size_t)b * words, blockOut.begin() + (size_t)(b + 1) * words, set.begin());
+		for (int i = blockBegin[b + 1] - 1; i >= blockBegin[b]; --i)
+		{
+			copy(set.begin(), set.end(), liveOut.begin() + (size_t)i * words);
+			for (int d = defBegin[i]; d < defBegin[i + 1]; ++d)
+				removeVariable(set.data(), defs[d]);
+			for (int u = useBegin[i]; u < useBegin[i + 1]; ++u)
+				addVariable(set.data(), uses[u]);
+			copy(set.begin(), set.end(), liveIn.begin() + (size_t)i * words);
+		}
+	}
+}
+
+
+void FlowGraph::setInterferences(vector<vector<int>>& matrix) const
+{
+	for (int i = 0; i < size; ++i)
+	{
+		const Word* o = liveOut.data() + (size_t)i * words;
+		for (int d = defBegin[i]; d < defBegin[i + 1]; ++d)
+		{
+			int defined = defs[d];
+			if (!hasVariable(o, defined))
+				continue;
+			for (int w = 0; w < words; ++w)
+				for (int b = 0; b < 64 && o[w] >> b != 0; ++b)
+				{
+					int v = w * 64 + b;
+					if (v != defined && (o[w] >> b & 1) != 0)
+					{
+						matrix[defined][v] = __INTERFERENCE__;
+						matrix[v][defined] = __INTERFERENCE__;
+					}
+				}
+		}
+	}
+}
+
+
+void FlowGraph::printRow(ostream& out, int position, Row row) const
+{
+	int i = position - begin;
+	switch (row)
+	{
+	case USE:
+		for (int u = useBegin[i]; u < useBegin[i + 1]; ++u)
+			out << ' ' << regs[uses[u]]->getName();
+		break;
+	case DEF:
+		for (int d = defBegin[i]; d < defBegin[i + 1]; ++d)
+			out << ' ' << regs[defs[d]]->getName();
+		break;
+	case SUCC:
+		for (int s = succBegin[i]; s < succBegin[i + 1]; ++s)
+			out << ' ' << begin + succs[s];
+		break;
+	case PRED:
+		for (int p = predBegin[i]; p < predBegin[i + 1]; ++p)
+			out << ' ' << begin + preds[p];
+		break;
+	case IN:
+		printSet(out, liveIn.data() + (size_t)i * words);
+		break;
+	case OUT:
+		printSet(out, liveOut.data() + (size_t)i * words);
+		break;
+	}
+}
+
+
+void FlowGraph::printSet(ostream& out, const Word* set) const
+{
+	for (int w = 0; w < words; ++w)
+		for (int b = 0; b < 64 && set[w] >> b != 0; ++b)
+			if ((set[w] >> b & 1) != 0)
+				out << ' ' << regs[w * 64 + b]->getName();
+}
+
+
+void FlowGraph::print(ostream& out) const
+{
+	for (int i = 0; i < size; ++i)
+		code[begin + i].printTable(out, begin + i, this);
+}
@@ -0,0 +1,149 @@
+#ifndef __FLOW_GRAPH__
+#define __FLOW_GRAPH__
+
+#include <vector>
+#include <cstdint>
+#include <ostream>
+
+#include "IR.h"
+
+/**
+ * Control flow graph of one function with the register variables that are live at its instructions
+ *
+ * Instructions are numbered from the label of the function (0). Edges are kept in CSR arrays:
+ * the successors of instruction i are succs[succBegin[i]] up to succs[succBegin[i + 1] - 1], the same
+ * goes for predecessors and for the used and defined variables. Register variables are numbered
+ * by their positions and the sets of live variables are bitsets with one row per instruction.
+ *
+ * Liveness is solved for basic blocks, which start at labels and after branches, and the sets
+ * of the instructions are found from the sets of their blocks with one pass through every block.
+ */
+class FlowGraph
+{
+public:
+	/**
+	 * Rows of the table an instruction is printed in (see Instruction::printTable)
+	 */
+	enum Row { USE, DEF, SUCC, PRED, IN, OUT };
+
+	/**
+	 * Constructor with paramaters
+	 * [in] context - compilation the instructions belong to
+	 * [in] code    - instructions of the program
+	 * [in] begin   - position of the label of the function in code
+	 * [in] end     - position after the last instruction of the function
+	 * [in] regs    - register variables used in the function by their positions
+	 * [in] labels  - positions of labeled instructions in code by the ids of their labels
+	 */
+	FlowGraph(CompilationContext& context, Instructions& code, int begin, int end, std::vector<Variable*>& regs,
+		const std::vector<int>& labels);
+
+	/**
+	 * Sets the successors and predecessors of all instructions
+	 * (jumps to labels of other functions get no successor)
+	 */
+	void setPredAndSucc();
+	/**
+	 * Sets the used and defined register variables of all instructions
+	 */
+	void setUseAndDef();
+	/**
+	 * Splits the instructions into basic blocks and sets the edges between the blocks and the
+	 * variables every block uses before defining them and defines (after setPredAndSucc and setUseAndDef)
+	 */
+	void setBlocks();
+	/**
+	 * Does one iteration of liveness analysis of the blocks, from the last block to the first one
+	 * [out] return - boolean value if the in or out set of some block changed
+	 */
+	bool iterate();
+	/**
+	 * Does liveness analysis of the blocks until no set changes, a block is analysed again
+	 * only when the input of one of its successors changes (the iterations done before are kept)
+	 */
+	void solve();
+	/**
+	 * Sets the in and out sets of the instructions from the sets of their blocks
+	 */
+	void setLiveVariables();
+
+	/**
+	 * Marks the variables that interfere in the interference matrix, a defined variable
+	 * interferes with all other variables that are live after the instruction
+	 * [in] matrix - interference matrix of the register variables of the function
+	 */
+	void setInterferences(std::vector<std::vector<int>>& matrix) const;
+
+	/**
+	 * Prints one row of the table of an instruction
+	 * [in] out      - stream the row is printed to
+	 * [in] position - position of the instruction in code
+	 * [in] row      - row of the table
+	 */
+	void printRow(std::ostream& out, int position, Row row) const;
+	/**
+	 * Prints the instructions of the function with the results of the analysis
+	 * [in] out - stream the instructions are printed to
+	 */
+	void print(std::ostream& out) const;
+
+private:
+	typedef std::uint64_t Word;   // Word of a bitset
+
+	/**
+	 * Sorts edges into CSR arrays, the order in which the edges were added is kept
+	 * [in]  edges   - pairs of instructions or blocks (from, to)
+	 * [in]  nodes   - number of instructions or blocks
+	 * [in]  reverse - true if the edges are sorted by the node they go to
+	 * [out] first   - position of the first edge of every node (and the number of edges at the end)
+	 * [out] other   - nodes at the other end of the edges
+	 */
+	static void sortEdges(const std::vector<std::pair<int, int>>& edges, int nodes, bool reverse, std::vector<int>& first, std::vector<int>& other);
+
+	/**
+	 * Sets the out set of a block from the inputs of its successors and its in set from the out set
+	 * [in]  b         - block
+	 * [in]  set       - words of one set, used while computing
+	 * [out] inChanged - boolean value if the in set changed
+	 * [out] return    - boolean value if the in or out set changed
+	 */
+	bool updateBlock(int b, std::vector<Word>& set, bool& inChanged);
+
+	/**
+	 * Prints the names of the variables of a set
+	 * [in] out - stream the names are printed to
+	 * [in] set - first word of the bitset
+	 */
+	void printSet(std::ostream& out, const Word* set) const;
+
+	CompilationContext& context;      // Compilation the instructions belong to
+	Instructions& code;               // Instructions of the program
+	int begin;                        // Position of the label of the function in code
+	int size;                         // Number of instructions of the function
+	std::vector<Variable*>& regs;     // Register variables by their positions
+	const std::vector<int>& labels;   // Positions of labeled instructions in code by the ids of their labels
+	int words;                        // Number of words of a set of variables
+
+	std::vector<int> succBegin;       // Successors (CSR)
+	std::vector<int> succs;
+	std::vector<int> predBegin;       // Predecessors (CSR)
+	std::vector<int> preds;
+	std::vector<int> useBegin;        // Positions of used variables (CSR)
+	std::vector<int> uses;
+	std::vector<int> defBegin;        // Positions of defined variables (CSR)
+	std::vector<int> defs;
+	std::vector<Word> liveIn;         // Sets of input variables, words per instruction
+	std::vector<Word> liveOut;        // Sets of output variables, words per instruction
+
+	std::vector<int> blockBegin;      // First instruction of every block (and the number of instructions at the end)
+	std::vector<int> blockSuccBegin;  // Successors of blocks (CSR)
+	std::vector<int> blockSuccs;
+	std::vector<int> blockPredBegin;  // Predecessors of blocks (CSR)
+	std::vector<int> blockPreds;
+	std::vector<Word> blockUse;       // Sets of variables used in a block before they are defined, words per block
+	std::vector<Word> blockDef;       // Sets of variables defined in a block, words per block
+	std::vector<Word> blockIn;        // Sets of input variables, words per block
+	std::vector<Word> blockOut;       // Sets of output variables, words per block
+};
+
+#endif
@@ -4,16 +4,32 @@
  */
 
 #include "IR.h"
+#include "FlowGraph.h"
 
  // ***********************************************
  // *            Variable methods                 *
  // ***********************************************
-unsigned Variable::counter = 0;
-
-std::string& Variable::getName()
+std::string_view Variable::getName() const
 {
 	return m_name;
 }
+unsigned Variable::getSymbol() const
+{
+	return m_symbol;
+}
+void Variable::setSymbol(unsigned symbol, std::string_view name)
+{
+	m_symbol = symbol;
+	m_name = name;
+}
+int Variable::getId() const
+{
+	return m_id;
+}
+void Variable::setId(int id)
+{
+	m_id = id;
+}
 Variable::VariableType& Variable::getType()
 {
 	return m_type;
@@ -30,6 +46,10 @@ int Variable::getPos() const
 {
 	return m_position;
 }
+void Variable::setPos(int pos)
+{
+	m_position = pos;
+}
 
 std::string Variable::get()
 {
@@ -47,9 +67,9 @@ std::string Variable::get()
 	case CONST_VAR:
 		return std::to_string(value);
 	case LABEL_VAR:
-		return m_name;
+		return std::string(m_name);
 	case MEM_VAR:
-		return m_name;
+		return std::string(m_name);
 	default:
 		return "error";
 	}
@@ -88,7 +108,7 @@ void Variable::printTable()
 	else
 		cout << value << '\n';
 }
-void print(std::list<Variable*>& vars)
+void print(Variables& vars)
 {
 	for (Variable* v : vars)
 		v->printTable();
@@ -97,252 +117,97 @@ void print(std::list<Variable*>& vars)
 // ***********************************************
 // *            Instruction methods              *
 // ***********************************************
-unsigned Instruction::counter = 0;
-
-void Instruction::addLabel(Variable* lab)
-{
-	label = lab;
-	if (lab->getType() != Variable::LABEL_VAR)
-		throw std::runtime_error("Not able to attach a non label variable to the instruction!");
-}
-void Instruction::addDst(Variable* var)
-{
-	m_dst.push_back(var);
-}
-void Instruction::addSrc(Variable* var)
-{
-	m_src.push_back(var);
-}
-void Instruction::addPred(Instruction* in)
-{
-	if (!contains(m_pred, in))
-		m_pred.push_back(in);
-}
-void Instruction::addSucc(Instruction* in)
-{
-	if (!contains(m_succ, in))
-		m_succ.push_back(in);
-}
-
-void Instruction::setUse()
+void Instruction::addLabel(int label)
 {
-	for (Variable* v : m_src)
-		if (v->getType() == Variable::REG_VAR)
-			m_use.push_back(v);
-	m_use.unique();
+	m_label = label;
 }
-void Instruction::setDef()
+void Instruction::addOperand(int var)
 {
-	for (Variable* v : m_dst)
-		if (v->getType() == Variable::REG_VAR)
-			m_def.push_back(v);
-	m_def.unique();
+	for (int& operand : m_operands)
+		if (operand == NO_VARIABLE)
+		{
+			operand = var;
+			return;
+		}
+	throw std::runtime_error("Not able to add more operands to the instruction than its format has!");
 }
 
 InstructionType Instruction::getType() const
 {
 	return m_type;
 }
-Variable* Instruction::getLabel() const
+int Instruction::getLabel() const
 {
-	return label;
+	return m_label;
 }
-
-Variables& Instruction::getSrc()
+int Instruction::getTarget() const
 {
-	return m_src;
+	int target = InstructionSet::get(m_type).target;
+	return target < 0 ? NO_VARIABLE : m_operands[target];
 }
-Variables& Instruction::getIn()
+int Instruction::getNumOfOperands() const
 {
-	return m_in;
+	return InstructionSet::get(m_type).numOperands;
 }
-Variables& Instruction::getOut()
+int& Instruction::getOperand(int i)
 {
-	return m_out;
+	return m_operands[i];
 }
-Variables& Instruction::getDef()
+OperandKind Instruction::getOperandKind(int i) const
 {
-	return m_def;
+	return InstructionSet::get(m_type).operands[i];
 }
 
-Variables Instruction::getSuccIns()
+bool Instruction::isFunc() const
 {
-	Variables vars;
-	for (Instruction* s : m_succ)
-		for (Variable* v : s->m_in)
-			if (!contains(vars, v))
-				vars.push_back(v);
-	return vars;
-}
-Variables Instruction::getUseWithOutWithoutDef()
-{
-	Variables vars;
-	for (Variable* v : m_out)
-		if (!contains(m_def, v))
-			vars.push_back(v);
-	for (Variable* v : m_use)
-		if (!contains(vars, v))
-			vars.push_back(v);
-	return vars;
+	return m_label != NO_VARIABLE && m_type == I_NO_TYPE;
 }
 
-Instruction* findInstructionWithLabel(Variable* lab, std::list<Instruction*>& ins)
+std::string Instruction::toString() const
 {
-	for (Instructions::iterator it = ins.begin(); it != ins.end(); ++it)
-		if ((*it)->label == lab)
-			return *it;
-	// It should always find an instruction with a label because the check is done at the
-	// end of syntax analysis, this is just an additional error for safety
-	throw std::runtime_error("No instruction with " + lab->getName() + " exists!");
-}
-Instruction* findInstructionAfterFunc(Instruction* in, std::list<Instruction*>& ins)
-{
-	for (Instructions::iterator it = ins.begin(); it != ins.end(); ++it)
-	{
-		if (*it == in)
-		{
-			++it;
-			if (it != ins.end())
-				return *it;
-		}
-	}
-	return nullptr;
-}
-void addEachother(Instruction& successor, Instruction& predecessor)
-{
-	successor.addPred(&predecessor);
-	predecessor.addSucc(&successor);
+	return InstructionSet::get(m_type).format;
 }
 
-bool Instruction::isFunc()
+void Instruction::write(std::ostream& out, CompilationContext& context) const
 {
-	if (label != nullptr && m_type == I_NO_TYPE)
-		return true;
+	if (m_label != NO_VARIABLE)
+		out << context.getVariable(m_label)->get() << ":" << (isFunc() ? "" : "\n\t");
 	else
-		return false;
-}
+		out << "\t";
 
-void replace(std::string& what, std::string& with)
-{
-	if (what.find("\'") == -1)
-		return;
-
-	what.replace(what.find("\'"), 2, with);
-}
-std::string Instruction::toString()
-{
-	std::string ret = "";
-	
-	switch (m_type)
+	// every 'x of the format is replaced with the next operand
+	const int* operand = m_operands;
+	for (const char* c = InstructionSet::get(m_type).format; *c != '\0'; ++c)
 	{
-	case I_ADD:
-		ret += "add \'d, \'s, \'s";
-		break;
-	case I_ADDI:
-		ret += "addi \'d, \'s, \'c";
-		break;
-	case I_B:
-		ret += "b \'l";
-		break;
-	case I_BLTZ:
-		ret += "bltz \'s, \'l";
-		break;
-	case I_LA:
-		ret += "la \'d, \'m";
-		break;
-	case I_LI:
-		ret += "li \'d, \'c";
-		break;
-	case I_LW:
-		ret += "lw \'d, \'c(\'s)";
-		break;
-	case I_SUB:
-		ret += "sub \'d, \'s, \'s";
-		break;
-	case I_SW:
-		ret += "sw \'s, \'c(\'s)";
-		break;
-	case I_NOP:
-		ret += "nop";
-		break;
-	case I_AND:
-		ret += "and \'d, \'s, \'s";
-		break;
-	case I_OR:
-		ret += "or \'d, \'s, \'s";
-		break;
-	case I_NOT:
-		ret += "not \'d, \'s";
-		break;
-	case I_BNE:
-		ret += "bne \'s, \'s, \'l";
+		if (*c == '\'' && c[1] != '\0')
+		{
+			++c;
+			out << context.getVariable(*operand++)->get();
+		}
+		else
+			out << *c;
 	}
-
-	return ret;
 }
 
-std::ostream& operator<<(std::ostream& out, Instruction& in)
+void Instruction::printTable(std::ostream& out, int position, const FlowGraph* graph) const
 {
-	std::string val = in.toString();
-	if (in.label != nullptr)
-		val = in.label->get() + ":" + (in.isFunc() ? "" : "\n\t") + val;
-	else
-		val = "\t" + val;
-	
-	for (Variable* dst : in.m_dst)
-		replace(val, dst->get());
-	for (Variable* src : in.m_src)
-		replace(val, src->get());
-
-	out << val;
-	return out;
-}
+	static const char* const rows[] = { "\n|  use |", "\n|  def |", "\n| succ |", "\n| pred |", "\n|   in |", "\n|  out |" };
 
-void Instruction::printTable()
-{
-	using std::cout;
-	cout <<   "=------===============------="
+	out <<   "=------===============------="
 		 << "\n|      | Instruction |      |"
 		 << "\n=------===============------="
-		 << "\n|  pos | " << m_position
-		 << "\n| type | " << toString()
-         << "\n|  use |";
-	for (Variable* v : m_use)
-		std::cout << ' ' << v->getName();
-	cout << "\n|  def |";
-	for (Variable* v : m_def)
-		std::cout << ' ' << v->getName();
-	cout << "\n| succ |";
-	for (Instruction* i : m_succ)
-		std::cout << ' ' << i->m_position;
-	cout << "\n| pred |";
-	for (Instruction* i : m_pred)
-		std::cout << ' ' << i->m_position;
-	cout << "\n|   in |";
-	for (Variable* v : m_in)
-		std::cout << ' ' << v->getName();
-	cout << "\n|  out |";
-	for (Variable* v : m_out)
-		std::cout << ' ' << v->getName();
-	cout << std::endl;
-}
-void print(std::list<Instruction*>& ins)
-{
-	for (Instruction* i : ins)
-		i->printTable();
-}
-
-bool contains(Instructions& ins, Instruction* in)
-{
-	for (Instruction* i : ins)
-		if (i == in)
-			return true;
-	return false;
+		 << "\n|  pos | " << position
+		 << "\n| type | " << toString();
+	for (int row = FlowGraph::USE; row <= FlowGraph::OUT; ++row)
+	{
+		out << rows[row];
+		if (graph != nullptr)
+			graph->printRow(out, position, (FlowGraph::Row)row);
+	}
+	out << std::endl;
 }
-bool contains(Variables& vars, Variable* var)
+void print(Instructions& ins, std::ostream& out)
 {
-	for (Variable* i : vars)
-		if (i == var)
-			return true;
-	return false;
-}
+	for (int i = 0; i < (int)ins.size(); ++i)
+		ins[i].printTable(out, i);
+}
\ No newline at end of file
@@ -6,7 +6,33 @@
 #ifndef __IR__
 #define __IR__
 
+#include <string_view>
+#include <vector>
+
 #include "Types.h"
+#include "InstructionSet.h"
+#include "Arena.h"
+#include "CompilationContext.h"
+
+class Variable;
+class Instruction;
+class FlowGraph;
+
+/**
+ * Id of a variable that isn't there (an instruction without a label or an operand it doesn't have)
+ */
+const int NO_VARIABLE = -1;
+
+/**
+ * This type represents list of variables from program code.
+ * Lists of variables take their nodes from the arena of the compilation.
+ */
+typedef std::list<Variable*, ArenaAllocator<Variable*>> Variables;
+
+/**
+ * This type represents instructions from program code, in the order they are written.
+ */
+typedef std::vector<Instruction> Instructions;
 
 /**
  * This class represents one variable from program code.
@@ -26,26 +52,51 @@ public:
 		NO_TYPE
 	};
 
-	Variable() : m_type(NO_TYPE), m_name(""), m_position(-1), m_assignment(no_assign), value(-1) {}
+	Variable() : m_type(NO_TYPE), m_symbol(NO_SYMBOL), m_name(""), m_id(NO_VARIABLE), m_position(-1), m_assignment(no_assign), value(-1) {}
 	/**
 	* Constructor with paramaters
-	* [in] type - type of variable created
-	* [in] name - name of the variable
-	* [in] val  - if the variable stores a value it is given here
-	*/
-	Variable(VariableType type, std::string name, int val = 0) : m_type(type), m_name(name), m_assignment(no_assign), value(val)
+	* [in] context - compilation the variable belongs to
+	* [in] type    - type of variable created
+	* [in] symbol  - symbol of the name of the variable
+	* [in] name    - name of the variable, stored in the symbol table (it is not copied)
+	* [in] val     - if the variable stores a value it is given here
+	*/
+	Variable(CompilationContext& context, VariableType type, unsigned symbol, std::string_view name, int val = 0) :
+		m_type(type), m_symbol(symbol), m_name(name), m_assignment(no_assign), value(val)
 	{
-		m_position = m_type == REG_VAR ? counter++ : -1;
+		m_id = context.addVariable(this);
+		m_position = m_type == REG_VAR ? context.nextVariablePosition() : -1;
 	}
 
 	// Getters are made by reference if the field is changed somewhere so
 	// that the returned value can be used as a lvalue
 
 	/**
-	* Returns name of the variable by reference
-	* [out] return - reference to name of the variable
+	* Returns name of the variable
+	* [out] return - view of the name in the symbol table
+	*/
+	std::string_view getName() const;
+	/**
+	* Returns symbol of the name of the variable
+	* [out] return - symbol
+	*/
+	unsigned getSymbol() const;
+	/**
+	* Sets the name of the variable (used when variables are moved to another symbol table)
+	* [in] symbol - symbol of the name
+	* [in] name   - name stored in the symbol table
 	*/
-	std::string& getName();
+	void setSymbol(unsigned symbol, std::string_view name);
+	/**
+	* Returns id of the variable, instructions refer to the variable by it
+	* [out] return - index of the variable in its compilation context
+	*/
+	int getId() const;
+	/**
+	* Sets id of the variable (used when variables are moved to another compilation context)
+	* [in] id - new id
+	*/
+	void setId(int id);
 	/**
 	* Returns type of the variable by reference
 	* [out] return - reference to type of the variable
@@ -66,6 +117,12 @@ public:
 	* [out] return - intiger value of the variables position
 	*/
 	int getPos() const;
+	/**
+	* Sets position of the variable in the interference matrix
+	* (used when variables from separately parsed parts of a program are merged)
+	* [in] pos - new position
+	*/
+	void setPos(int pos);
 
 	/**
 	* Method used for changing a part of instruction that is being written 
@@ -85,7 +142,7 @@ public:
 	* Friend function which prints values of all variables from a list
 	* [in] vars - list of variables
 	*/
-	friend void print(std::list<Variable*>& vars);
+	friend void print(Variables& vars);
 
 private:
 	/**
@@ -99,69 +156,45 @@ private:
 	*/
 	void printTable();
 
-	static unsigned counter;   // Static field representing the amount of register variables
 	int value;                 // Intiger value stored in the variable (if it needs it)
 	VariableType m_type;       // Type of variable
-	std::string m_name;        // Name of the variable gotten from the token
+	unsigned m_symbol;         // Symbol of the name of the variable
+	std::string_view m_name;   // Name of the variable gotten from the token (stored in the symbol table)
+	int m_id;                  // Index of the variable in its compilation context
 	int m_position;            // Position of the variable in the interference matrix (used for resource allocation)
 	Regs m_assignment;         // Register assigned to a variable if it needs it
 };
 
-/**
- * This type represents list of variables from program code.
- */
-typedef std::list<Variable*> Variables;
-
 
 /**
- * This class represents one instruction in program code.
+ * This class represents one instruction in program code, a fixed size record kept in a vector of
+ * instructions (its position in the vector is its position in code). Variables are referred to by
+ * their ids (see CompilationContext::getVariable), NO_VARIABLE marks an operand or label that isn't there.
  */
 class Instruction
 {
 public:
-	Instruction () : label(nullptr), m_position(counter++), m_type(I_NO_TYPE) {}
 	/**
 	* Constructor with paramaters
-	* [in] type - type of instruction created
-	* [in] lab  - variable of the type label
-	*/
-	Instruction (InstructionType type, Variable* lab = nullptr) :
-		label(lab), m_position(counter++), m_type(type) {}
-
-	/**
-	* Set the label pointer if the instruction has a label before it
-	* [in] lab - variable of type label
-	*/
-	void addLabel(Variable* lab);
-	/**
-	* Add a destination register
-	* [in] var - variable of type register
-	*/
-	void addDst(Variable* var);
-	/**
-	* Add a source register
-	* [in] var - variable of type register
-	*/
-	void addSrc(Variable* var);
-	/**
-	* Add a predecessor instruction
-	* [in] in - instruction to add as a predecessor
-	*/
-	void addPred(Instruction* in);
-	/**
-	* Add a successor instruction
-	* [in] in - instruction to add as a successor
+	* [in] type  - type of instruction created
+	* [in] label - id of the label variable, NO_VARIABLE if the instruction doesn't have a label
 	*/
-	void addSucc(Instruction* in);
+	Instruction(InstructionType type, int label = NO_VARIABLE) : m_type(type), m_label(label)
+	{
+		for (int& operand : m_operands)
+			operand = NO_VARIABLE;
+	}
 
 	/**
-	* Set the list of variables used in the instruction
+	* Set the label if the instruction has a label before it
+	* [in] label - id of the label variable
 	*/
-	void setUse();
+	void addLabel(int label);
 	/**
-	* Set the list of variables defined in the instruction
+	* Add the next operand, operands are added in the order they are written in the format
+	* [in] var - id of the variable
 	*/
-	void setDef();
+	void addOperand(int var);
 
 	/**
 	* Method that returns the type of instruction
@@ -170,131 +203,69 @@ public:
 	InstructionType getType() const;
 	/**
 	* Method that returns the label variable
-	* [out] return - pointer to the label variable
+	* [out] return - id of the label variable, NO_VARIABLE if there isn't one
 	*/
-	Variable* getLabel() const;
-
+	int getLabel() const;
 	/**
-	* Returns the list of source variables by reference
-	* [out] return - list of variables by reference
+	* Method that returns the label the instruction jumps to
+	* [out] return - id of the label variable, NO_VARIABLE if the instruction isn't a branch
 	*/
-	Variables& getSrc();
+	int getTarget() const;
 	/**
-	* Returns the list of input variables by reference
-	* [out] return - list of variables by reference
+	* Returns the number of operands of the instruction
 	*/
-	Variables& getIn();
+	int getNumOfOperands() const;
 	/**
-	* Returns the list of output variables by reference
-	* [out] return - list of variables by reference
+	* Returns an operand of the instruction by reference (used when variables from separately
+	* parsed parts of a program are merged)
+	* [in]  i      - position of the operand in the format
+	* [out] return - reference to the id of the variable
 	*/
-	Variables& getOut();
+	int& getOperand(int i);
 	/**
-	* Returns the list of defined variables in the instruction by reference
-	* [out] return - list of variables by reference
+	* Returns the kind of an operand of the instruction
+	* [in]  i      - position of the operand in the format
+	* [out] return - kind of the operand
 	*/
-	Variables& getDef();
-
-	/**
-	* Method used in liveness analysis
-	* Gets all input variables of all successor instructions
-	* [out] return - list of all input variables
-	*/
-	Variables getSuccIns();
-	/**
-	* Method used in liveness analysis
-	* Gets all used variables with all output variables without defined variables
-	* [out] return - list of the union of the wanted variables
-	*/
-	Variables getUseWithOutWithoutDef();
-
-	/**
-	* Friend function that goes through a list of instructions and find the one with the specific label
-	* [in]  lab    - label variable whose pair we are trying to find
-	* [in]  ins    - list of instructions
-	* [out] return - pointer to the instruction with the given label
-	*/
-	friend Instruction* findInstructionWithLabel(Variable* lab, std::list<Instruction*>& ins);
-	/**
-	* Friend function that is used to find the instruction after a specified instruction
-	* (used for finding the instruction after a function)
-	* [in]  in     - instruction whose successor we are searching for
-	* [in]  ins    - list of instructions
-	* [out] return - pointer to the instruction after the given instruction
-	*/
-	friend Instruction* findInstructionAfterFunc(Instruction* in, std::list<Instruction*>& ins);
-	/**
-	* Friend function which adds a successor to the predecessor instruction
-	* and a predecessor to the successor instruction
-	* [in] successor   - instruction to which to add a predecessor
-	* [in] predecessor - instruction to which to add a successor
-	*/
-	friend void addEachother(Instruction& successor, Instruction& predecessor);
+	OperandKind getOperandKind(int i) const;
 
 	/**
 	* Returns if the instruction is a function type (I_NO_TYPE and has a label)
 	* [out] return - boolean value
 	*/
-	bool isFunc();
+	bool isFunc() const;
 
 	/**
-	* Method which returns the string of instruction depending on the type of instruction
+	* Method which returns the format of the instruction from its descriptor
 	* Example: I_ADD -> add 'd, 's, 's
 	* [out] return - string of the instruction
 	*/
-	std::string toString();
+	std::string toString() const;
 	/**
-	* Operator overload for bitwise left operator for writting into a file (part of std libraries)
+	* Writes the instruction as assembly
+	* [in] out     - stream the instruction is written to
+	* [in] context - compilation the variables of the instruction belong to
 	*/
-	friend std::ostream& operator<<(std::ostream& out, Instruction& in);
+	void write(std::ostream& out, CompilationContext& context) const;
 	/**
-	* Friend function which prints the whole list of instructions passed in
-	* [in] ins - list of instructions
+	* Method which prints the contents of the instruction in the form of a table of contents
+	* [in] out      - stream the table is printed to
+	* [in] position - position of the instruction in code
+	* [in] graph    - control flow graph of the function of the instruction that gives the rest of the table,
+	*                 nullptr if the function wasn't analysed
 	*/
-	friend void print(std::list<Instruction*>& ins);
-
-private:
+	void printTable(std::ostream& out, int position, const FlowGraph* graph = nullptr) const;
 	/**
-	* Method which prints the contents of the instruction in the form of a table of contents onto the terminal
+	* Friend function which prints the whole vector of instructions passed in
+	* [in] ins - instructions
+	* [in] out - stream the instructions are printed to
 	*/
-	void printTable();
+	friend void print(Instructions& ins, std::ostream& out);
 
-	static unsigned counter;          // Static field that represents the amount of instructions
-	Variable* label;                  // Pointer to the label variable
-
-	int m_position;                   // Position of the instruction in code
+private:
 	InstructionType m_type;           // Type of instruction
-	
-	Variables m_dst;                  // List of destination registers (variables)
-	Variables m_src;                  // List of source registers (variables)
-
-	Variables m_use;                  // List of variables used in the instruction
-	Variables m_def;                  // List of variables defined in the instruction
-	Variables m_in;                   // List of input variables
-	Variables m_out;                  // List of output variables
-	std::list<Instruction*> m_succ;	  // List of successor instructions
-	std::list<Instruction*> m_pred;   // List of predecessor instructions
+	int m_label;                      // Id of the label variable
+	int m_operands[MAX_OPERANDS];     // Ids of the operands in the order they are written in the format
 };
 
-
-/**
- * This type represents list of instructions from program code.
- */
-typedef std::list<Instruction*> Instructions;
-
-/**
-* Function to check if the variable is already contained in the list of variables
-* [in]  vars - list of variables
-* [in]  var - variable that is being checked
-* [out] return - boolean value if the variable is already in the list
-*/
-bool contains(Variables& vars, Variable* var);
-/**
-* Function to check if the instruction is already contained in the list of instructions
-* [in]  ins - list of instructions
-* [in]  in - instrcution that is being checked
-* [out] return - boolean value if the instruction is already in the list
-*/
-bool contains(Instructions& ins, Instruction* in);
-
 #endif
@@ -0,0 +1,54 @@
+#ifndef __IR_IMAGE__
+#define __IR_IMAGE__
+
+#include <cstdint>
+
+#include "Constants.h"
+
+/**
+ * Binary image of a program after syntax analysis, loaded instead of lexing and parsing the program again
+ * (see SyntaxAnalysis::writeImage and SyntaxAnalysis::readImage).
+ *
+ * All records have a fixed size, so a memory mapped image is read as it is:
+ *   ImageHeader
+ *   ImageVariable[]      variables in the order of their lists: registers, memory, labels, constants,
+ *                        memory variables declared in other modules (the position in this array is
+ *                        the index the instructions use)
+ *   ImageInstruction[]   instructions in program order
+ *   names                characters of the names of the variables, one after the other
+ * Numbers are stored in the byte order of the machine that wrote the image.
+ */
+
+/**
+ * Magic number at the start of every image
+ */
+const char IR_IMAGE_MAGIC[8] = { 'M', 'A', 'V', 'N', ' ', 'I', 'R', '\0' };
+
+struct ImageHeader
+{
+	char magic[8];                 // IR_IMAGE_MAGIC
+	uint32_t version;              // IR_IMAGE_VERSION
+	uint32_t numOfRegs;            // Number of register variables
+	uint32_t numOfMems;            // Number of memory variables
+	uint32_t numOfLabels;          // Number of labels
+	uint32_t numOfConsts;          // Number of constants
+	uint32_t numOfExterns;         // Number of memory variables declared in other modules
+	uint32_t numOfInstructions;    // Number of instructions
+	uint32_t sizeOfNames;          // Number of characters of the names
+};
+
+struct ImageVariable
+{
+	uint32_t nameOffset;           // Position of the first character of the name in the names
+	uint32_t nameLength;           // Number of characters of the name
+	int32_t value;                 // Value of the variable (1 for labels that are defined)
+};
+
+struct ImageInstruction
+{
+	int32_t type;                  // Type of the instruction
+	int32_t label;                 // Index of the label variable, -1 if there isn't one
+	int32_t operands[MAX_OPERANDS]; // Indices of the operands in the order they are written in the format, -1 if there isn't one
+};
+
+#endif
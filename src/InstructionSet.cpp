@@ -0,0 +1,154 @@
+#include "InstructionSet.h"
+
+using namespace std;
+
+
+constexpr InstructionDefinition InstructionSet::instructions[NUM_OF_INSTRUCTIONS] =
+{
+	{ I_NO_TYPE,	T_NO_TYPE,	"",						NO_BRANCH },
+	{ I_ADD,		T_ADD,		"add 'd, 's, 's",		NO_BRANCH },
+	{ I_ADDI,		T_ADDI,		"addi 'd, 's, 'c",		NO_BRANCH },
+	{ I_SUB,		T_SUB,		"sub 'd, 's, 's",		NO_BRANCH },
+	{ I_LA,			T_LA,		"la 'd, 'm",			NO_BRANCH },
+	{ I_LI,			T_LI,		"li 'd, 'c",			NO_BRANCH },
+	{ I_LW,			T_LW,		"lw 'd, 'c('s)",		NO_BRANCH },
+	{ I_SW,			T_SW,		"sw 's, 'c('s)",		NO_BRANCH },
+	{ I_BLTZ,		T_BLTZ,		"bltz 's, 'l",			CONDITIONAL_BRANCH },
+	{ I_B,			T_B,		"b 'l",					UNCONDITIONAL_BRANCH },
+	{ I_NOP,		T_NOP,		"nop",					NO_BRANCH },
+	{ I_AND,		T_AND,		"and 'd, 's, 's",		NO_BRANCH },
+	{ I_OR,			T_OR,		"or 'd, 's, 's",		NO_BRANCH },
+	{ I_NOT,		T_NOT,		"not 'd, 's",			NO_BRANCH },
+	{ I_BNE,		T_BNE,		"bne 's, 's, 'l",		CONDITIONAL_BRANCH }
+};
+
+
+/**
+ * Returns the token an operand of the given kind is read from, T_NO_TYPE for unsupported kinds
+ */
+static constexpr TokenType operandToken(char kind)
+{
+	switch (kind)
+	{
+	case O_DST:
+	case O_SRC:		return T_R_ID;
+	case O_CONST:	return T_NUM;
+	case O_MEM:		return T_M_ID;
+	case O_LABEL:	return T_ID;
+	default:		return T_NO_TYPE;
+	}
+}
+
+
+/**
+ * Returns the token of a punctuation character of a format, T_NO_TYPE for unsupported characters
+ */
+static constexpr TokenType punctuationToken(char c)
+{
+	switch (c)
+	{
+	case ',':	return T_COMMA;
+	case '(':	return T_L_PARENT;
+	case ')':	return T_R_PARENT;
+	default:	return T_NO_TYPE;
+	}
+}
+
+
+constexpr InstructionDescriptor InstructionSet::compile(const InstructionDefinition& definition)
+{
+	InstructionDescriptor descriptor = {};
+	descriptor.type = definition.type;
+	descriptor.token = definition.token;
+	descriptor.format = definition.format;
+	descriptor.branch = definition.branch;
+	descriptor.numSteps = 0;
+	descriptor.numOperands = 0;
+	descriptor.target = -1;
+
+	// the operands start after the mnemonic
+	const char* c = descriptor.format;
+	while (*c != '\0' && *c != ' ')
+		c++;
+
+	for (; *c != '\0' && descriptor.numSteps < MAX_INSTRUCTION_STEPS; c++)
+	{
+		OperandStep& step = descriptor.steps[descriptor.numSteps];
+		if (*c == '\'' && operandToken(c[1]) != T_NO_TYPE)
+		{
+			c++;
+			step.token = operandToken(*c);
+			step.kind = (OperandKind)*c;
+			if (step.kind == O_LABEL)
+				descriptor.target = (signed char)descriptor.numOperands;
+			if (descriptor.numOperands < MAX_OPERANDS)
+				descriptor.operands[descriptor.numOperands] = step.kind;
+			descriptor.numOperands++;
+			descriptor.numSteps++;
+		}
+		else if (punctuationToken(*c) != T_NO_TYPE)
+		{
+			step.token = punctuationToken(*c);
+			step.kind = O_NONE;
+			descriptor.numSteps++;
+		}
+	}
+	return descriptor;
+}
+
+
+constexpr InstructionTable InstructionSet::buildTable()
+{
+	InstructionTable result = {};
+	for (int i = 0; i <= T_ERROR; i++)
+	{
+		result.byToken[i] = -1;
+	}
+	for (int i = 0; i < NUM_OF_INSTRUCTIONS; i++)
+	{
+		result.byType[instructions[i].type] = compile(instructions[i]);
+		if (instructions[i].token != T_NO_TYPE)
+			result.byToken[instructions[i].token] = (signed char)instructions[i].type;
+	}
+	return result;
+}
+
+
+constexpr bool InstructionSet::isValid()
+{
+	for (int i = 0; i < NUM_OF_INSTRUCTIONS; i++)
+	{
+		if (instructions[i].type != i)
+			return false;
+
+		int numSteps = 0;
+		int numOperands = 0;
+		const char* c = instructions[i].format;
+		while (*c != '\0' && *c != ' ')
+			c++;
+		for (; *c != '\0'; c++)
+		{
+			if (*c == '\'' && operandToken(c[1]) != T_NO_TYPE)
+			{
+				c++;
+				numOperands++;
+			}
+			else if (punctuationToken(*c) == T_NO_TYPE && *c != ' ')
+				return false;
+			if (*c != ' ')
+				numSteps++;
+		}
+		if (numSteps > MAX_INSTRUCTION_STEPS || numOperands > MAX_OPERANDS)
+			return false;
+
+		// only branches read a label, which is where they jump to
+		if ((instructions[i].branch != NO_BRANCH) != (compile(instructions[i]).target >= 0))
+			return false;
+	}
+	return true;
+}
+
+static_assert(InstructionSet::isValid(), "Instruction formats are not supported by InstructionSet");
+
+
+constexpr InstructionTable InstructionSet::table = InstructionSet::buildTable();
@@ -0,0 +1,131 @@
+#ifndef __INSTRUCTION_SET__
+#define __INSTRUCTION_SET__
+
+#include "Constants.h"
+#include "Types.h"
+
+/**
+ * Kinds of operands, written in instruction formats as the letter after '
+ */
+enum OperandKind
+{
+	O_NONE = 0,     // punctuation, not an operand
+	O_DST = 'd',    // register variable defined by the instruction
+	O_SRC = 's',    // register variable used by the instruction
+	O_CONST = 'c',  // number, read as a constant variable
+	O_MEM = 'm',    // memory variable
+	O_LABEL = 'l'   // label the instruction jumps to
+};
+
+/**
+ * How an instruction changes the order in which instructions are executed
+ */
+enum BranchKind
+{
+	NO_BRANCH,            // continues with the next instruction
+	CONDITIONAL_BRANCH,   // continues with the next instruction or the one with the label
+	UNCONDITIONAL_BRANCH  // continues with the instruction with the label
+};
+
+/**
+ * One step of reading the operands of an instruction, a punctuation token or an operand
+ */
+struct OperandStep
+{
+	TokenType token;    // Token that is read
+	OperandKind kind;   // Kind of operand the token is read as (O_NONE for punctuation)
+};
+
+/**
+ * Hand-written definition of one instruction, a row of the instruction table
+ */
+struct InstructionDefinition
+{
+	InstructionType type;   // Type of the instruction
+	TokenType token;        // Reserved word the instruction starts with
+	const char* format;     // Assembly format, each 'x is replaced with the next operand of kind x
+	BranchKind branch;      // How the instruction changes the flow of the program
+};
+
+/**
+ * Description of one instruction, everything the phases need to know about its operands
+ */
+struct InstructionDescriptor
+{
+	InstructionType type;   // Type of the instruction
+	TokenType token;        // Reserved word the instruction starts with
+	const char* format;     // Assembly format, each 'x is replaced with the next operand of kind x
+	BranchKind branch;      // How the instruction changes the flow of the program
+
+	// Generated at compile time from the format
+	unsigned char numSteps;                     // Number of steps of reading the operands
+	OperandStep steps[MAX_INSTRUCTION_STEPS];   // Steps of reading the operands, in the order they are written
+	unsigned char numOperands;                  // Number of operands (steps that aren't punctuation)
+	OperandKind operands[MAX_OPERANDS];         // Kinds of the operands, in the order they are written
+	signed char target;                         // Position of the label among the operands, -1 if there isn't one
+};
+
+/**
+ * Table of supported instructions
+ */
+struct InstructionTable
+{
+	InstructionDescriptor byType[NUM_OF_INSTRUCTIONS];   // Descriptors by instruction type
+	signed char byToken[T_ERROR + 1];                     // Instruction types by reserved word, -1 if none
+};
+
+class InstructionSet
+{
+public:
+	/**
+	 * Returns the descriptor of the instruction type
+	 */
+	static const InstructionDescriptor& get(InstructionType type)
+	{
+		return table.byType[type];
+	}
+
+	/**
+	 * Returns the descriptor of the instruction starting with the given reserved word
+	 * [in]  token  - type of the current token
+	 * [out] return - pointer to the descriptor, nullptr if no instruction starts with the token
+	 */
+	static const InstructionDescriptor* find(TokenType token)
+	{
+		int type = table.byToken[token];
+		return type < 0 ? nullptr : &table.byType[type];
+	}
+
+	/**
+	 * Checks that the formats only contain supported punctuation and at most MAX_OPERANDS operands
+	 * and that every descriptor is at the position of its type (evaluated at compile time)
+	 */
+	static constexpr bool isValid();
+
+private:
+	/**
+	 * Expands the definition into a descriptor, generating the operands from its format
+	 * (evaluated at compile time)
+	 * [in]  definition - type, token, format and branch kind of the instruction
+	 * [out] return     - complete descriptor
+	 */
+	static constexpr InstructionDescriptor compile(const InstructionDefinition& definition);
+
+	/**
+	 * Builds the table from instructions (evaluated at compile time)
+	 */
+	static constexpr InstructionTable buildTable();
+
+	/**
+	 * Supported instructions in the order of InstructionType, to add a new one add a row here
+	 * and increase NUM_OF_INSTRUCTIONS
+	 */
+	static const InstructionDefinition instructions[NUM_OF_INSTRUCTIONS];
+
+	/**
+	 * Table of instructions, generated at compile time from instructions
+	 */
+	static const InstructionTable table;
+};
+
+#endif
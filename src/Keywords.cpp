@@ -0,0 +1,62 @@
+#include "Keywords.h"
+
+using namespace std;
+
+
+constexpr Keyword Keywords::keywords[NUM_OF_KEYWORDS] =
+{
+	{ "_mem",	T_MEM },
+	{ "_reg",	T_REG },
+	{ "_func",	T_FUNC },
+	{ "add",	T_ADD },
+	{ "addi",	T_ADDI },
+	{ "sub",	T_SUB },
+	{ "la",		T_LA },
+	{ "li",		T_LI },
+	{ "lw",		T_LW },
+	{ "sw",		T_SW },
+	{ "bltz",	T_BLTZ },
+	{ "b",		T_B },
+	{ "nop",	T_NOP },
+	{ "and",	T_AND },
+	{ "or",		T_OR },
+	{ "not",	T_NOT },
+	{ "bne",	T_BNE }
+};
+
+
+constexpr bool Keywords::isPerfect(unsigned seed)
+{
+	bool used[KEYWORD_TABLE_SIZE] = {};
+	for (int i = 0; i < NUM_OF_KEYWORDS; i++)
+	{
+		unsigned h = hash(keywords[i].name, seed);
+		if (used[h])
+			return false;
+		used[h] = true;
+	}
+	return true;
+}
+
+
+constexpr KeywordTable Keywords::buildTable()
+{
+	KeywordTable result = {};
+	while (!isPerfect(result.seed))
+	{
+		result.seed++;
+	}
+	for (int i = 0; i < NUM_OF_KEYWORDS; i++)
+	{
+		string_view name = keywords[i].name;
+		unsigned h = hash(name, result.seed);
+		result.slot[h] = keywords[i];
+		result.length[h] = (unsigned char)name.size();
+		if (name.size() > result.maxLength)
+			result.maxLength = name.size();
+	}
+	return result;
+}
+
+
+constexpr KeywordTable Keywords::table = Keywords::buildTable();
@@ -0,0 +1,88 @@
+#ifndef __KEYWORDS__
+#define __KEYWORDS__
+
+#include <string_view>
+#include <cstring>
+
+#include "Constants.h"
+#include "Types.h"
+
+/**
+ * Reserved word and the token type it is read as
+ */
+struct Keyword
+{
+	const char* name;
+	TokenType type;
+};
+
+/**
+ * Perfect hash table of reserved words: every reserved word has its own slot,
+ * so a lookup is one hash and at most one comparison
+ */
+struct KeywordTable
+{
+	unsigned seed;                            // Seed of the hash function for which there are no collisions
+	size_t maxLength;                         // Length of the longest reserved word
+	Keyword slot[KEYWORD_TABLE_SIZE];         // Reserved words by hash, empty slots have name nullptr
+	unsigned char length[KEYWORD_TABLE_SIZE]; // Lengths of the reserved words by hash
+};
+
+class Keywords
+{
+public:
+	/**
+	 * Returns the token type of the reserved word
+	 * [in]  word       - lexeme of an identifier
+	 * [in]  notKeyword - token type returned if the word is not reserved
+	 * [out] return     - token type
+	 */
+	static TokenType find(std::string_view word, TokenType notKeyword)
+	{
+		if (word.size() > table.maxLength)
+			return notKeyword;
+
+		unsigned h = hash(word, table.seed);
+		if (table.length[h] != word.size() || memcmp(table.slot[h].name, word.data(), word.size()) != 0)
+			return notKeyword;
+
+		return table.slot[h].type;
+	}
+
+private:
+	/**
+	 * Hash function of the table (evaluated at compile time while the table is built)
+	 * [in]  word   - lexeme to hash
+	 * [in]  seed   - seed of the hash function
+	 * [out] return - slot in the table
+	 */
+	static constexpr unsigned hash(std::string_view word, unsigned seed)
+	{
+		unsigned h = seed ^ (unsigned)word.size();
+		for (char c : word)
+			h = h * 31 + (unsigned char)c;
+		return (h ^ (h >> 7)) & (KEYWORD_TABLE_SIZE - 1);
+	}
+
+	/**
+	 * Returns true if no two reserved words hash to the same slot with the given seed
+	 */
+	static constexpr bool isPerfect(unsigned seed);
+
+	/**
+	 * Builds the table with the first seed for which the hash is perfect (evaluated at compile time)
+	 */
+	static constexpr KeywordTable buildTable();
+
+	/**
+	 * Reserved words, to add a new one add it here and increase NUM_OF_KEYWORDS
+	 */
+	static const Keyword keywords[NUM_OF_KEYWORDS];
+
+	/**
+	 * Hash table of reserved words, generated at compile time from keywords
+	 */
+	static const KeywordTable table;
+};
+
+#endif
@@ -1,40 +1,66 @@
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <algorithm>
 
 #include "Constants.h"
 #include "LexicalAnalysis.h"
 #include "Token.h"
+#include "DirectScanner.h"
+#include "CharacterClassifier.h"
 
 using namespace std;
 
 
+LexicalAnalysis::LexicalAnalysis(CompilationContext& context) :
+	programBufferPosition(0), validatedPosition(0), unsupportedCharacterFound(false), context(context) {}
+
+
 void LexicalAnalysis::initialize()
 {
 	programBufferPosition = 0;
-	fsm.initStateMachine();
+	validatedPosition = 0;
+	unsupportedCharacterFound = false;
 }
 
 
 bool LexicalAnalysis::Do()
 {
+	// tokens point into the program buffer, so a streamed input can't be moved while it is read
+	bufferWholeInput();
+	tokenList.reserve(programBuffer.data(), programBuffer.size());
+
 	while (true)
 	{
-		Token token = getNextTokenLex();
+		Token token = getNextToken();
+		tokenList.push_back(token);
 		switch (token.getType())
 		{
 			case T_ERROR:
-				errorToken = token;
-				tokenList.push_back(token);
 				return false;
 			case T_END_OF_FILE:
-				tokenList.push_back(token);
 				return true;
+			default:
+				break;
+		}
+	}
+}
+
+
+Token LexicalAnalysis::getNextToken()
+{
+	while (true)
+	{
+		Token token = getNextTokenLex();
+		switch (token.getType())
+		{
+			case T_ERROR:
+				errorToken = token;
+				return token;
 			case T_WHITE_SPACE:
 				continue;
 			default:
-				tokenList.push_back(token);
-				break;
+				return token;
 		}
 	}
 }
@@ -42,123 +68,146 @@ bool LexicalAnalysis::Do()
 
 bool LexicalAnalysis::readInputFile(string fileName)
 {
-	inputFile.open(fileName, ios_base::binary);
+	return programBuffer.open(fileName);
+}
 
-	if (!inputFile)
-		return false;
-	
-	inputFile.seekg(0, inputFile.end);
-	int length = (int)inputFile.tellg();
-	inputFile.seekg (0, inputFile.beg);
-	programBuffer.resize(length);
-	if (length > 0)
-		inputFile.read(&programBuffer.front(), length);
-	inputFile.close();
-	return true;
+
+void LexicalAnalysis::readInputBuffer(const char* source, size_t length)
+{
+	programBuffer.borrow(source, length);
 }
 
 
-Token LexicalAnalysis::getNextTokenLex()
+void LexicalAnalysis::bufferWholeInput()
 {
-	int currentState = START_STATE;
-	int nextState = 0;
-	int lastFiniteState = 0;
+	programBuffer.readToEnd();
+}
+
 
-	// position in stream
-	int counter = 0;
-	int lastLetterPos = programBufferPosition;
+const SourceBuffer& LexicalAnalysis::getProgramBuffer() const
+{
+	return programBuffer;
+}
 
+
+Token LexicalAnalysis::getNextTokenLex()
+{
 	Token token;
 
 	while (true)
 	{
-		char letter;
-		unsigned int letterIndex = programBufferPosition + counter;
+		const char* program = programBuffer.data();
+
+		// only the validated part of the buffer is handed to the scanners, it can not contain
+		// unsupported characters, so comment bodies end at the first line end
+		const char* limit = program + validatedPosition;
 
-		if (letterIndex < programBuffer.size())
+		// white space tokens are dropped anyway, skip the whole run at once
+		const char* begin = CharacterClassifier::skipWhiteSpace(program + programBufferPosition, limit);
+		programBufferPosition = (size_t)(begin - program);
+
+		if (begin == limit && validateInput())
+			continue;
+
+		if (programBufferPosition >= programBuffer.size())
 		{
-			letter = programBuffer[letterIndex];
+			// we have reached end of file and printed out the last correct token
+			// create EOF token and exit
+			token.makeEofToken();
+			return token;
 		}
-		else
+
+		int lastFiniteState = IDLE_STATE;
+		const char* end = begin;
+		LexicalError error = LE_MALFORMED_TOKEN;
+
+		if (begin == limit)
 		{
-			// we have reached the end of input file, force the search letter to invalid value
-			letter = -1;
-			if (programBufferPosition >= programBuffer.size())
-			{
-				// if we have reached end of file and printed out the last correct token
-				// create EOF token and exit
-				token.makeEofToken();
-				return token;
-			}
+			// unsupported character, no need to run the FSM
+			error = LE_UNSUPPORTED_CHARACTER;
 		}
-		
-		nextState = this->fsm.getNextState(currentState, letter);
-		counter++;
-
-		if (nextState > IDLE_STATE)
+		else if (limit - begin >= 2 && begin[0] == '/' && begin[1] == '/')
+		{
+			lastFiniteState = COMMENT_STATE;
+			end = CharacterClassifier::findLineEnd(begin + 2, limit);
+		}
+		else
 		{
-			// change the current state
-			currentState = nextState;
+#ifdef DIRECT_CODED_SCANNER
+			end = DirectScanner::scan(begin, limit, lastFiniteState);
+#else
+			end = FiniteStateMachine::scan(begin, limit, lastFiniteState);
+#endif
+		}
 
-			if (nextState == START_STATE)
-				throw runtime_error("\nException: Infinite state detected! There is something very wrong with the code !\n");
+		// the token may continue past the validated part, validate more and scan it again
+		if (end == limit && validateInput())
+			continue;
 
-			// remember last finite state
-			lastFiniteState = nextState;
-			lastLetterPos = programBufferPosition + counter;
-		}
-		else if (nextState == INVALID_STATE)
+		if (lastFiniteState != IDLE_STATE)
 		{
-			// eof character read, generate token defined with last finite state
-			if (lastFiniteState != IDLE_STATE)
-			{
-				// token recognized, make token
-				token.makeToken(programBufferPosition, lastLetterPos, programBuffer, lastFiniteState);
-				programBufferPosition = lastLetterPos;
-				return token;
-			}
-			else
-			{
-				// error occurred, create error token
-				token.makeErrorToken(programBufferPosition + counter - 1, programBuffer);
-				programBufferPosition = programBufferPosition + counter - 1;
-				return token;
-			}
+			// token recognized, make token
+			size_t lastLetterPos = (size_t)(end - program);
+			token.makeToken(programBufferPosition, lastLetterPos, program, lastFiniteState);
+			if (token.getType() == T_ID || token.getType() == T_M_ID || token.getType() == T_R_ID)
+				token.setSymbol(context.getSymbols().intern(token.getValue()));
+			programBufferPosition = lastLetterPos;
 		}
 		else
 		{
-			// final state reached, state machine is in IDLE state
-			// calculate the number of characters needed for the recognized token
-			int len = lastLetterPos - programBufferPosition;
-
-			// create the token
-			if (len > 0)
-			{
-				// token recognized, make token
-				token.makeToken(programBufferPosition, lastLetterPos, programBuffer, lastFiniteState);
-				programBufferPosition = lastLetterPos;
-				return token;
-			}
-			else
-			{
-				// error occurred, create error token
-				token.makeErrorToken(programBufferPosition + counter - 1, programBuffer);
-				programBufferPosition = programBufferPosition + counter - 1;
-				return token;
-			}
+			// error occurred, the first character can not start a token, create error token
+			token.makeErrorToken(programBufferPosition, program, error);
 		}
+
+		return token;
+	}
+}
+
+
+bool LexicalAnalysis::validateInput()
+{
+	if (unsupportedCharacterFound)
+		return false;
+
+	if (validatedPosition >= programBuffer.size())
+	{
+		if (!programBuffer.refill(programBufferPosition))
+			return false;
+
+		validatedPosition -= programBufferPosition;
+		programBufferPosition = 0;
+		if (validatedPosition >= programBuffer.size())
+			return true;
 	}
 
-	return token;
+	const char* program = programBuffer.data();
+	const char* chunkEnd = program + min(programBuffer.size(), validatedPosition + VALIDATION_CHUNK_SIZE);
+	const char* found = CharacterClassifier::findUnsupported(program + validatedPosition, chunkEnd);
+
+	validatedPosition = (size_t)(found - program);
+	unsupportedCharacterFound = found != chunkEnd;
+	return true;
 }
 
 
-TokenList& LexicalAnalysis::getTokenList()
+TokenStream& LexicalAnalysis::getTokenList()
 {
 	return tokenList;
 }
 
 
+SymbolTable& LexicalAnalysis::getSymbols()
+{
+	return context.getSymbols();
+}
+
+
+CompilationContext& LexicalAnalysis::getContext()
+{
+	return context;
+}
+
+
 void LexicalAnalysis::printTokens()
 {
 	if (tokenList.empty())
@@ -168,10 +217,9 @@ void LexicalAnalysis::printTokens()
 	else
 	{
 		printMessageHeader();
-		TokenList::iterator it = tokenList.begin();
-		for (; it != tokenList.end(); it++)
+		for (size_t i = 0; i < tokenList.size(); i++)
 		{
-			(*it).printTokenInfo();
+			tokenList.at(i).printTokenInfo();
 		}
 	}
 }
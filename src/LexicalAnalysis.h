@@ -6,16 +6,23 @@
 #include <list>
 
 #include "Token.h"
+#include "TokenStream.h"
 #include "FiniteStateMachine.h"
+#include "SourceBuffer.h"
+#include "CompilationContext.h"
 
 
-typedef std::list<Token> TokenList;
-
 class LexicalAnalysis
 {
 public:
 	/**
-	 * Method for initializing the lexical analysis and FSM
+	 * Constructor of the lexical analysis of one compilation
+	 * [in] context - compilation the names of identifiers are stored in
+	 */
+	LexicalAnalysis(CompilationContext& context);
+
+	/**
+	 * Method for initializing the lexical analysis
 	 */
 	void initialize();
 
@@ -25,23 +32,66 @@ public:
 	bool Do();
 
 	/**
-	 * Method for reading the input file
+	 * Method for reading the input file, "-" reads the standard input
 	 */
 	bool readInputFile(std::string fileName);
 
+	/**
+	 * Method for using a part of another program buffer as the input, the characters are not copied
+	 * [in] source - first character of the input, must outlive the lexical analysis
+	 * [in] length - number of characters in the input
+	 */
+	void readInputBuffer(const char* source, size_t length);
+
+	/**
+	 * Reads the rest of a streamed input (standard input or a pipe) into the program buffer,
+	 * so that token values stay valid until the lexical analysis is destroyed
+	 */
+	void bufferWholeInput();
+
+	/**
+	 * Returns the contents of the input
+	 */
+	const SourceBuffer& getProgramBuffer() const;
+
 	/**
 	 * Use this function to get next lexical token from program source code.
+	 * If the input is streamed the token value is only valid until the next call.
 	 *
 	 * @return next lexical token in program source code
 	 */
 	Token getNextTokenLex();
 
+	/**
+	 * Use this function to get next token that is not white space. If the token is errornous
+	 * it is remembered so that it can be printed with printLexError.
+	 * If the input is streamed the token value is only valid until the next call.
+	 *
+	 * @return next token in program source code
+	 */
+	Token getNextToken();
+
 	/**
 	 * Use this function to get the list of tokens read from the source code
 	 *
 	 * @return list of tokens
 	 */
-	TokenList& getTokenList();
+	TokenStream& getTokenList();
+
+	/**
+	 * Use this function to get the names of identifiers read from the source code,
+	 * identifier tokens carry their symbol in this table
+	 *
+	 * @return symbol table
+	 */
+	SymbolTable& getSymbols();
+
+	/**
+	 * Use this function to get the compilation the source code belongs to
+	 *
+	 * @return compilation context
+	 */
+	CompilationContext& getContext();
 
 	/**
 	 * Prints the token list
@@ -57,35 +107,45 @@ public:
 
 private:
 	/**
-	 * Input file containing program text to be analyzed
+	 * Program buffer containing the contents of the input file (memory mapped when possible)
 	 */
-	std::ifstream inputFile;
+	SourceBuffer programBuffer;
 
 	/**
-	 * Program buffer containing the contents of the input files
+	 * Current position of the program buffer
 	 */
-	std::vector<char> programBuffer;
+	size_t programBufferPosition;
 
 	/**
-	 * Current position of the program buffer
+	 * End of the part of the program buffer checked for unsupported characters.
+	 * If unsupportedCharacterFound is set, the character at this position is not supported.
 	 */
-	unsigned int programBufferPosition;
+	size_t validatedPosition;
+	bool unsupportedCharacterFound;
 
 	/**
-	 * Finite state machine object
+	 * List of parsed tokens
 	 */
-	FiniteStateMachine fsm;
+	TokenStream tokenList;
 
 	/**
-	 * List of parsed tokens
+	 * Compilation the source code belongs to, it keeps the names of the identifiers that were read
 	 */
-	TokenList tokenList;
+	CompilationContext& context;
 
 	/**
 	 * IF an error occurs while parsing this attribute will hold the errornous Token
 	 */
 	Token errorToken;
 
+	/**
+	 * Checks the next chunk of the program buffer for unsupported characters, reading more
+	 * of a streamed input once the whole buffer is checked (the characters before the current
+	 * position are dropped then)
+	 * [out] return - false if the whole input has already been checked
+	 */
+	bool validateInput();
+
 	/**
 	 * Used for printing the test list. It decorates the output with header naming the columns
 	 */
@@ -0,0 +1,156 @@
+#include "Linker.h"
+
+#include <iostream>
+#include <cctype>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_set>
+
+using namespace std;
+
+
+void Linker::addModule(const string& name, Module module)
+{
+	names.push_back(name);
+	modules.push_back(move(module));
+}
+
+
+bool Linker::Do()
+{
+	// exported symbols by the module that defines them
+	unordered_map<string, size_t> functions;
+	unordered_map<string, size_t> memory;
+	for (size_t m = 0; m < modules.size(); ++m)
+	{
+		for (const Module::Function& function : modules[m].functions)
+		{
+			unordered_map<string, size_t>::iterator found = functions.emplace(function.name, m).first;
+			if (found->second != m)
+			{
+				err = true;
+				cerr << "Function " << function.name << " is defined in " << names[found->second]
+				     << " and in " << names[m] << "!" << endl;
+				return false;
+			}
+		}
+		for (const Module::Memory& var : modules[m].memory)
+		{
+			unordered_map<string, size_t>::iterator found = memory.emplace(var.name, m).first;
+			if (found->second != m)
+			{
+				err = true;
+				cerr << "Memory variable " << var.name << " is declared in " << names[found->second]
+				     << " and in " << names[m] << "!" << endl;
+				return false;
+			}
+		}
+	}
+
+	for (size_t m = 0; m < modules.size(); ++m)
+	{
+		for (const string& label : modules[m].externLabels)
+			if (functions.count(label) == 0)
+			{
+				err = true;
+				cerr << "Label: " << label << " used in " << names[m] << " doesn\'t exist!" << endl;
+				return false;
+			}
+		for (const string& name : modules[m].externMemory)
+			if (memory.count(name) == 0)
+			{
+				err = true;
+				cerr << "Memory variable " << name << " used in " << names[m] << " isn\'t declared!" << endl;
+				return false;
+			}
+	}
+
+	// local labels keep their names unless the name is already used in the program
+	unordered_set<string> taken;
+	for (const pair<const string, size_t>& function : functions)
+		taken.insert(function.first);
+	for (Module& module : modules)
+	{
+		unordered_map<string, string> renamed;
+		for (string& label : module.labels)
+		{
+			if (taken.insert(label).second)
+				continue;
+			string name;
+			for (int k = 1; !taken.insert(name = label + "_" + to_string(k)).second; ++k)
+				;
+			renamed[label] = name;
+			label = name;
+		}
+		if (!renamed.empty())
+			for (Module::Function& function : module.functions)
+				for (string& line : function.lines)
+					line = renameSymbols(line, renamed);
+	}
+
+	return !err;
+}
+
+
+string Linker::renameSymbols(const string& line, const unordered_map<string, string>& renamed)
+{
+	string result;
+	size_t pos = 0;
+	while (pos < line.size())
+	{
+		if (!isalnum((unsigned char)line[pos]) && line[pos] != '_')
+		{
+			result += line[pos++];
+			continue;
+		}
+
+		size_t end = pos;
+		while (end < line.size() && (isalnum((unsigned char)line[end]) || line[end] == '_'))
+			++end;
+		string name = line.substr(pos, end - pos);
+		unordered_map<string, string>::const_iterator found = renamed.find(name);
+		if (found != renamed.end() && (pos == 0 || line[pos - 1] != '$'))
+			result += found->second;
+		else
+			result += name;
+		pos = end;
+	}
+	return result;
+}
+
+
+void Linker::writeToFile(string& nameOfOutputFile)
+{
+	ofstream file(nameOfOutputFile);
+	if (!file.is_open())
+		throw runtime_error("\nException! Wasn\'t able to create the output file!");
+
+	for (const Module& module : modules)
+		for (const Module::Function& function : module.functions)
+			file << ".globl " << function.name << "\n";
+	file << "\n";
+
+	file << ".data" << endl;
+	for (const Module& module : modules)
+		for (const Module::Memory& var : module.memory)
+			file << var.name << ":\t.word " << var.value << endl;
+	file << "\n";
+
+	file << ".text" << endl;
+	bool first = true;
+	for (const Module& module : modules)
+		for (const Module::Function& function : module.functions)
+		{
+			if (!first)
+				file << "\n\n";
+			first = false;
+
+			file << function.name << ":" << endl;
+			for (const string& line : function.lines)
+				file << line << endl;
+
+			// every function returns at its end
+			file << "\tjr $ra";
+		}
+	file.close();
+}
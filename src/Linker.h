@@ -0,0 +1,53 @@
+#ifndef __LINKER__
+#define __LINKER__
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "Module.h"
+
+/**
+ * Link step of separate compilation, merges modules into one assembly program
+ */
+class Linker
+{
+public:
+	Linker() : err(false) {}
+
+	/**
+	 * Adds a module to the program, modules are placed in the program in the order they are added
+	 * [in] name   - name of the module used in error messages (path of its file)
+	 * [in] module - compiled module
+	 */
+	void addModule(const std::string& name, Module module);
+
+	/**
+	 * Method which resolves the symbols of the modules. Every function and memory variable has to be
+	 * defined by exactly one module and everything a module imports has to be defined by some module.
+	 * Local labels that have the name of a function or of a label of an earlier module are renamed.
+	 * [out] return - boolean value if the modules were linked without a problem
+	 */
+	bool Do();
+
+	/**
+	 * Creates a file with the given path and writes the linked program into it
+	 * [in] nameOfOutputFile - string of the path where the output file is
+	 */
+	void writeToFile(std::string& nameOfOutputFile);
+
+private:
+	/**
+	 * Replaces the names of symbols in a line of assembly (register names are left as they are)
+	 * [in]  line    - line of assembly
+	 * [in]  renamed - new names of symbols by their old names
+	 * [out] return  - line with the new names
+	 */
+	static std::string renameSymbols(const std::string& line, const std::unordered_map<std::string, std::string>& renamed);
+
+	bool err;                         // Boolean value that shows if there has been an error while linking
+	std::vector<std::string> names;   // Names of the modules
+	std::vector<Module> modules;      // Modules in the order they are placed in the program
+};
+
+#endif
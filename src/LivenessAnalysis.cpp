@@ -3,87 +3,187 @@
  * Datum: 31. 05. 2024.
  */
 
+#include <thread>
+#include <atomic>
+#include <exception>
+
 #include "LivenessAnalysis.h"
+#include "Linker.h"
 
-LivenessAnalysis::LivenessAnalysis(SyntaxAnalysis& syntax) :
-	err(false), reg_vars(syntax.getRegs()), mem_vars(syntax.getMem()),
-	instrs(syntax.getInstructions()), interferenceGraph()
+LivenessAnalysis::LivenessAnalysis(SyntaxAnalysis& syntax, int dumps, AllocationCache* cache) :
+	err(false), dumps(dumps), context(syntax.getContext()), reg_vars(syntax.getRegs()), mem_vars(syntax.getMem()),
+	label_vars(syntax.getLabels()), extern_vars(syntax.getExterns()), label_positions(syntax.getLabelPositions()),
+	instrs(syntax.getInstructions()), functions(), cache(cache)
 {
-	setPredAndSucc();
-	setUseAndDef();
-	for (int j = 0; j < (int)reg_vars.size(); ++j)
+	// a function gets the instructions up to the next function
+	std::vector<Function*> users(reg_vars.size(), nullptr);
+	for (int i = 0; i < (int)instrs.size(); ++i)
 	{
-		interferenceGraph.push_back({});
-		for (int i = 0; i < (int)reg_vars.size(); ++i)
-			interferenceGraph[j].push_back(0);
+		if (instrs[i].isFunc() || functions.empty())
+			functions.emplace_back(new Function(i));
+		Function& function = *functions.back();
+		function.end = i + 1;
+		for (int o = 0; o < instrs[i].getNumOfOperands(); ++o)
+		{
+			Variable* var = context.getVariable(instrs[i].getOperand(o));
+			if (var->getType() == Variable::REG_VAR)
+				users[var->getPos()] = &function;
+		}
+	}
+
+	// every register variable is used in one function (checked by syntax analysis),
+	// the ones that aren't used are allocated with the first function
+	for (Variable* var : reg_vars)
+	{
+		Function* function = users[var->getPos()];
+		if (function == nullptr)
+			function = functions.front().get();
+		function->reg_vars.push_back(var);
+	}
+	for (std::unique_ptr<Function>& function : functions)
+	{
+		int position = 0;
+		for (Variable* var : function->reg_vars)
+			var->setPos(position++);
 	}
 }
 
 bool LivenessAnalysis::Do()
 {
-	liveness();
-	setGraph();
-	resourceAllocation();
+	// workers take the functions one by one until all of them are analysed
+	std::vector<std::exception_ptr> failures(functions.size());
+	std::atomic<size_t> next(0);
+	auto work = [this, &failures, &next]()
+	{
+		for (size_t f = next++; f < functions.size(); f = next++)
+		{
+			try
+			{
+				analyse(*functions[f]);
+			}
+			catch (...)
+			{
+				failures[f] = std::current_exception();
+			}
+		}
+	};
+	size_t numOfWorkers = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), functions.size());
+	std::vector<std::thread> workers;
+	for (size_t worker = 1; worker < numOfWorkers; ++worker)
+		workers.emplace_back(work);
+	work();
+	for (std::thread& worker : workers)
+		worker.join();
+
+	// the output is printed in source order, so the error reported is the first one in the program
+	for (size_t f = 0; f < functions.size(); ++f)
+	{
+		std::cout << functions[f]->log.str();
+		if (failures[f])
+			std::rethrow_exception(failures[f]);
+		if (functions[f]->err)
+		{
+			err = true;
+			break;
+		}
+	}
 
 	return !err;
 }
 
-void LivenessAnalysis::liveness()
+void LivenessAnalysis::analyse(Function& function)
 {
-	bool prevGood = true;
-	bool done = false;
-
-	for (int counter = 0; !done && counter < 10; ++counter)
+	// the iterations printed with dumps aren't kept, so with dumps every function is analysed
+	bool cached = cache != nullptr && dumps == __NO_DUMPS__;
+	std::string key;
+	if (cached)
 	{
-		for (Instructions::reverse_iterator rit = instrs.rbegin(); rit != instrs.rend(); ++rit)
+		key = getKey(function);
+		AllocationCache::Entry entry;
+		if (cache->find(key, entry))
 		{
-			Instruction& curr = **rit;
-			Variables savedIn = curr.getIn();
-			Variables savedOut = curr.getOut();
+			function.interferenceGraph = std::move(entry.interferenceGraph);
+			for (int position : entry.order)
+				function.vars.push_back(function.reg_vars[position]);
+			for (Variable* var : function.reg_vars)
+				var->getAssignment() = entry.assignments[var->getPos()];
+			return;
+		}
+	}
 
-			Variables& in = curr.getIn();
-			Variables& out = curr.getOut();
+	function.graph.reset(new FlowGraph(context, instrs, function.begin, function.end, function.reg_vars, label_positions));
+	function.graph->setPredAndSucc();
+	function.graph->setUseAndDef();
+	function.graph->setBlocks();
+	int size = (int)function.reg_vars.size();
+	function.interferenceGraph.assign(size, std::vector<int>(size, 0));
 
-			out.clear();
-			out = curr.getSuccIns();
-			
-			in.clear();
-			in = curr.getUseWithOutWithoutDef();
+	liveness(function);
+	setGraph(function);
+	resourceAllocation(function);
 
-			if (prevGood)
-				if (savedIn != in || savedOut != out)
-				{
-					prevGood = false;
-				}
-		}
-		done = prevGood;
-		prevGood = true;
-		std::cout << ">>>>>=====-----\n"
-		          << "| Iteration " << counter + 1 << ":\n"
-				  << ">>>>>=====-----\n";
-		print(instrs);
+	if (cached && !function.err)
+	{
+		AllocationCache::Entry entry;
+		entry.interferenceGraph = function.interferenceGraph;
+		for (Variable* var : function.vars)
+			entry.order.push_back(var->getPos());
+		for (Variable* var : function.reg_vars)
+			entry.assignments.push_back(var->getAssignment());
+		cache->insert(key, std::move(entry));
 	}
 }
-void LivenessAnalysis::setGraph()
+
+std::string LivenessAnalysis::getKey(Function& function)
 {
-	for (Instructions::iterator it = instrs.begin(); it != instrs.end(); ++it)
+	std::vector<int> key;
+	key.push_back((int)function.reg_vars.size());
+	for (int i = function.begin; i < function.end; ++i)
 	{
-		Instruction& i = **it;
-		Variables& out = i.getOut();
-		Variables& def = i.getDef();
-		for (Variables::iterator it = def.begin(); it != def.end(); ++it)
+		// labeled instructions start basic blocks
+		key.push_back(instrs[i].getType());
+		key.push_back(instrs[i].getLabel() != NO_VARIABLE);
+		for (int o = 0; o < instrs[i].getNumOfOperands(); ++o)
 		{
-			Variable* definedVar = *it;
-			if (contains(out, definedVar))
-				for (Variable* v : out)
-					if (v != definedVar)
-						setInterference(v->getPos(), definedVar->getPos());
+			OperandKind kind = instrs[i].getOperandKind(o);
+			if (kind == O_SRC || kind == O_DST)
+				key.push_back(context.getVariable(instrs[i].getOperand(o))->getPos());
+		}
+
+		// the same target FlowGraph::setPredAndSucc finds, branches out of the function have none
+		if (InstructionSet::get(instrs[i].getType()).branch != NO_BRANCH)
+		{
+			int label = instrs[i].getTarget();
+			int target = label < (int)label_positions.size() ? label_positions[label] - function.begin : -1;
+			key.push_back(target >= 0 && target < function.end - function.begin ? target : -1);
 		}
 	}
+	return std::string((const char*)key.data(), key.size() * sizeof(int));
 }
-void LivenessAnalysis::resourceAllocation()
+
+void LivenessAnalysis::liveness(Function& function)
 {
-	std::stack<Variable*> simplificationStack = createSimplificationStack();
+	// only the first iterations are printed, the analysis goes on until no set changes
+	bool done = dumps != __DUMPS__;
+	for (int counter = 0; !done && counter < 10; ++counter)
+	{
+		done = !function.graph->iterate();
+		function.graph->setLiveVariables();
+		function.log << ">>>>>=====-----\n"
+		             << "| Iteration " << counter + 1 << ":\n"
+				     << ">>>>>=====-----\n";
+		function.graph->print(function.log);
+	}
+	function.graph->solve();
+	function.graph->setLiveVariables();
+}
+void LivenessAnalysis::setGraph(Function& function)
+{
+	function.graph->setInterferences(function.interferenceGraph);
+}
+void LivenessAnalysis::resourceAllocation(Function& function)
+{
+	std::stack<Variable*> simplificationStack = createSimplificationStack(function);
 	
 	Variable* in_use;
 	Variable* prev = nullptr;
@@ -92,16 +192,16 @@ void LivenessAnalysis::resourceAllocation()
 		in_use = simplificationStack.top();
 		simplificationStack.pop();
 
-		vars.push_back(in_use);
+		function.vars.push_back(in_use);
 
 		if (prev == nullptr) {
 			int counter = 1;
 			in_use->getAssignment() = (Regs)counter;
 		}
 		else {
-			int color = getColor(in_use);
+			int color = getColor(function, in_use);
 			if (color == -1) {
-				err = true;
+				function.err = true;
 				return;
 			}
 			else {
@@ -169,37 +269,32 @@ int findElementWithHighestRang(std::vector<std::vector<int>>& matrix)
 
 	return max;
 }
-std::stack<Variable*> LivenessAnalysis::createSimplificationStack()
+std::stack<Variable*> LivenessAnalysis::createSimplificationStack(Function& function)
 {
 	std::stack<Variable*> result;
 
-	Matrix matrixToWorkOn = interferenceGraph;
-	Variables notYetTaken = reg_vars;
-	Variables::iterator found;
+	Matrix matrixToWorkOn = function.interferenceGraph;
+	std::vector<Variable*> notYetTaken = function.reg_vars;
 
 	int curr;
-	for (int i = 0; i < (int)interferenceGraph.size(); ++i)
+	for (int i = 0; i < (int)function.interferenceGraph.size(); ++i)
 	{
 		curr = findElementWithHighestRang(matrixToWorkOn);
 		removeElementOfMatrix(curr, matrixToWorkOn);
 
-		found = notYetTaken.begin();
-		for (int j = 0; j < curr; ++j)
-			++found;
-
-		result.push(*found);
-		notYetTaken.erase(found);
+		result.push(notYetTaken[curr]);
+		notYetTaken.erase(notYetTaken.begin() + curr);
 	}
 
 	return result;
 }
-int LivenessAnalysis::getColor(Variable* var) {
+int LivenessAnalysis::getColor(Function& function, Variable* var) {
 	std::list<int> allReg;
 	for (int i = 1; i <= __REG_NUMBER__; ++i)
 		allReg.push_back(i);
 
-	for (Variable* other : vars)
-		if (interferenceGraph[var->getPos()][other->getPos()] == 1)
+	for (Variable* other : function.vars)
+		if (function.interferenceGraph[var->getPos()][other->getPos()] == 1)
 			allReg.remove((int)other->getAssignment());
 
 	if (allReg.empty())
@@ -208,64 +303,6 @@ int LivenessAnalysis::getColor(Variable* var) {
 		return allReg.front();
 }
 
-void LivenessAnalysis::setPredAndSucc()
-{
-	Instructions::iterator currentInstruction = instrs.begin();
-	Instructions::iterator prevInstruction = currentInstruction++;
-	
-	Instruction* labeledInstruction;
-	bool shouldAddToNext = true; // Used just to indicate that if a jump/branch (without a condition) instruction happend that the next instruction shouldn't get the jump/branch instruction as a predecessor or a successor
-	while (currentInstruction != instrs.end())
-	{
-		Instruction& curr = **currentInstruction;
-		Instruction& prev = **prevInstruction;
-
-		if (!prev.isFunc() && shouldAddToNext)
-		{
-			addEachother(curr, prev);
-		}
-		if (!shouldAddToNext)
-			shouldAddToNext = true;
-
-		switch (curr.getType())
-		{
-		case I_B:
-			shouldAddToNext = false;
-			labeledInstruction = findInstructionWithLabel(curr.getSrc().back(), instrs);
-			if (labeledInstruction->isFunc())
-				labeledInstruction = findInstructionAfterFunc(labeledInstruction, instrs);
-			if (labeledInstruction != nullptr)
-				addEachother(*labeledInstruction, curr);
-			break;
-		case I_BLTZ:
-			labeledInstruction = findInstructionWithLabel(curr.getSrc().back(), instrs);
-			if (labeledInstruction->isFunc())
-				labeledInstruction = findInstructionAfterFunc(labeledInstruction, instrs);
-			if (labeledInstruction != nullptr)
-				addEachother(*labeledInstruction, curr);
-		case I_BNE:
-			labeledInstruction = findInstructionWithLabel(curr.getSrc().back(), instrs);
-			if (labeledInstruction->isFunc())
-				labeledInstruction = findInstructionAfterFunc(labeledInstruction, instrs);
-			if (labeledInstruction != nullptr)
-				addEachother(*labeledInstruction, curr);
-		}
-		prevInstruction = currentInstruction;
-		++currentInstruction;
-		if (currentInstruction != instrs.end())
-			if ((*currentInstruction)->isFunc())
-				++currentInstruction;
-	}
-}
-void LivenessAnalysis::setUseAndDef()
-{
-	for (Instruction* i : instrs)
-	{
-		i->setDef();
-		i->setUse();
-	}
-}
-
 void LivenessAnalysis::printRegisters()
 {
 	std::cout << ">>>>>=====-----\n"
@@ -278,41 +315,63 @@ void LivenessAnalysis::printGraph()
 	std::cout << "=---===============---=\n"
 	          << "| Interference Matrix |\n"
               << "=---===============---=\n";
-	for (int j = 0; j < (int)interferenceGraph.size(); ++j)
+	for (std::unique_ptr<Function>& function : functions)
 	{
-		std::cout << "[";
-		for (std::vector<int>::iterator it = interferenceGraph[j].begin();
-			it != interferenceGraph[j].end();
-			++it)
+		Matrix& interferenceGraph = function->interferenceGraph;
+		if (functions.size() > 1)
+			std::cout << "| " << context.getVariable(instrs[function->begin].getLabel())->getName() << ":\n";
+		for (int j = 0; j < (int)interferenceGraph.size(); ++j)
 		{
-			std::cout << ' ' << *it;
+			std::cout << "[";
+			for (std::vector<int>::iterator it = interferenceGraph[j].begin();
+				it != interferenceGraph[j].end();
+				++it)
+			{
+				std::cout << ' ' << *it;
+			}
+			std::cout << " ]\n";
 		}
-		std::cout << " ]\n";
 	}
 }
-void LivenessAnalysis::setInterference(int x, int y)
+void LivenessAnalysis::writeToFile(std::string& nameOfOutputFile)
 {
-	interferenceGraph[y][x] = 1;
-	interferenceGraph[x][y] = 1;
+	// the program is a module linked on its own
+	Linker linker;
+	linker.addModule(nameOfOutputFile, getModule());
+	if (!linker.Do())
+		throw std::runtime_error("\nException! The program uses labels or memory variables it doesn\'t define!");
+	linker.writeToFile(nameOfOutputFile);
 }
-
-void LivenessAnalysis::writeToFile(std::string& nameOfOutputFile)
+Module LivenessAnalysis::getModule()
 {
-	std::ofstream file(nameOfOutputFile);
-	if (!file.is_open())
-		throw std::runtime_error("\nException! Wasn\'t able to create the output file!");
-
-	file << ".globl " << instrs.front()->getLabel()->get() << "\n\n";
-
-	file << ".data" << std::endl;
+	Module module;
 	for (Variable* v : mem_vars)
-		file << v->get() << ":\t.word " << v->getValue() << std::endl;
-	file << "\n";
-
-	file << ".text" << std::endl;
-	for (Instruction* i : instrs)
-		file << *i << std::endl;
-
-	file << "\tjr $ra";
-	file.close();
+		module.memory.push_back({ v->get(), v->getValue() });
+	for (Variable* v : label_vars)
+		if (v->getValue() != 1)
+			module.externLabels.push_back(v->get());
+	for (Variable* v : extern_vars)
+		module.externMemory.push_back(v->get());
+
+	for (std::unique_ptr<Function>& function : functions)
+	{
+		module.functions.push_back({ context.getVariable(instrs[function->begin].getLabel())->get(), {} });
+		std::vector<std::string>& lines = module.functions.back().lines;
+		for (int i = function->begin; i < function->end; ++i)
+		{
+			if (instrs[i].isFunc())
+				continue;
+			if (instrs[i].getLabel() != NO_VARIABLE)
+				module.labels.push_back(context.getVariable(instrs[i].getLabel())->get());
+
+			// a labeled instruction is written in two lines
+			std::ostringstream text;
+			instrs[i].write(text, context);
+			std::istringstream split(text.str());
+			std::string line;
+			while (std::getline(split, line))
+				lines.push_back(line);
+		}
+	}
+	return module;
 }
@@ -7,21 +7,31 @@
 #define LIVNESS_ANALYSIS_H
 
 #include "SyntaxAnalysis.h"
+#include "FlowGraph.h"
+#include "Module.h"
+#include "AllocationCache.h"
 
 /**
 * Class that does liveness analysis of register variables and assigns them processor registers
+*
+* Every function of the program (a _func label and the instructions up to the next one) is
+* analysed on its own, with its own interference graph, so functions are analysed in parallel.
 */
 class LivenessAnalysis
 {
 public:
 	/**
 	* Constructior with paramaters
-	* [in] syntax - SyntaxAnalysis object from which LivenessAnalysis takes instructions and variables
+	* [in] syntax - SyntaxAnalysis object from which LivenessAnalysis takes instructions, variables
+	*               and the compilation context they belong to
+	* [in] dumps  - __DUMPS__ if every iteration of liveness analysis is printed, __NO_DUMPS__ otherwise
+	* [in] cache  - results of functions analysed by earlier compilations, used without dumps (none if nullptr)
 	*/
-	LivenessAnalysis(SyntaxAnalysis& syntax);
+	LivenessAnalysis(SyntaxAnalysis& syntax, int dumps = __DUMPS__, AllocationCache* cache = nullptr);
 
 	/**
-	* Method which runs all the liveness analysis and resource allocation methods
+	* Method which runs all the liveness analysis and resource allocation methods, functions are
+	* analysed by a pool of threads and their output is printed in source order
 	* [out] return - boolean value if everything was done correctly
 	*/
 	bool Do();
@@ -31,65 +41,96 @@ public:
 	*/
 	void writeToFile(std::string& nameOfOutputFile);
 	/**
+	* Returns the analysed code as a module that can be linked with other modules
+	* [out] return - module with the assembly of the functions and the symbols they use
+	*/
+	Module getModule();
+	/**
 	* Method for printing to the terminal all the register variables after they got
 	* assigned an actual processor register
 	*/
 	void printRegisters();
 	/**
-	* Method which prints the interference matrix/graph to the terminal
+	* Method which prints the interference matrices/graphs of the functions to the terminal
 	*/
 	void printGraph();
 
 private:
+	typedef std::vector<std::vector<int>> Matrix;   // Matrix type defined  to represent the interference graph
+
 	/**
-	* Main method which does liveness analysis
+	* One function of the program and the results of its analysis
 	*/
-	void liveness();
+	struct Function
+	{
+		Function(int begin) : begin(begin), end(begin), reg_vars(), vars(), graph(), interferenceGraph(), log(), err(false) {}
+
+		int begin;                          // Position of the function label in instrs
+		int end;                            // Position after the last instruction of the function
+		std::vector<Variable*> reg_vars;    // Register variables used in the function by their positions (starting from zero)
+		std::vector<Variable*> vars;        // List of variables that gets filled when a variable gets assigned a register
+		std::unique_ptr<FlowGraph> graph;   // Control flow graph of the function with the results of liveness analysis
+		Matrix interferenceGraph;           // Interference graph of the register variables of the function
+		std::ostringstream log;             // Output of the analysis, printed after all the functions are analysed
+		bool err;                           // Boolean value that represents if registers couldn't be allocated
+	};
+
 	/**
-	* Method which prepares the interference matrix/graph
+	* Method which does liveness analysis and resource allocation of one function
+	* [in] function - function that is analysed
 	*/
-	void setGraph();
+	void analyse(Function& function);
 	/**
-	* Method which allocates processor registers to register variables
+	* Method which makes the key a function is kept in the cache by. It holds the instructions of the function
+	* with what their flow graph and interference graph depend on: register variables by their positions and
+	* targets of branches by their positions in the function, so the key doesn't depend on names or ids
+	* [in]  function - function whose key is made
+	* [out] return   - key of the function
 	*/
-	void resourceAllocation();
+	std::string getKey(Function& function);
 
 	/**
-	* Method that sets all predecessors and successor of all instructions
+	* Main method which does liveness analysis
+	* [in] function - function that is analysed
 	*/
-	void setPredAndSucc();
+	void liveness(Function& function);
 	/**
-	* Method that sets all used and defined variables of all instructions
+	* Method which prepares the interference matrix/graph
+	* [in] function - function that is analysed
 	*/
-	void setUseAndDef();
-
+	void setGraph(Function& function);
 	/**
-	* Method that ensures that the interference matrix is symmetrical over the main diagonal
-	* [in] x - position of one variable
-	* [in] y - position of the other variable which interferes with the first one
+	* Method which allocates processor registers to register variables
+	* [in] function - function that is analysed
 	*/
-	void setInterference(int x, int y);
+	void resourceAllocation(Function& function);
 
 	/**
 	* Method which creates the simplification stack used for resource allocation
-	* [out] return - stack of variables in order of their rang in the graph
+	* [in]  function - function that is analysed
+	* [out] return   - stack of variables in order of their rang in the graph
 	*/
-	std::stack<Variable*> createSimplificationStack();
+	std::stack<Variable*> createSimplificationStack(Function& function);
 	/**
 	* Method that determines what register should a given variable get compared to the interference
 	* matrix/graph and other variables that got their register assigned
-	* [in]  var    - pointer to the variable for which the color (register) is being chosen for
-	* [out] return - next free color (register)
+	* [in]  function - function that is analysed
+	* [in]  var      - pointer to the variable for which the color (register) is being chosen for
+	* [out] return   - next free color (register)
 	*/
-	int getColor(Variable* var);
+	int getColor(Function& function, Variable* var);
 
 	bool err;                                       // Boolean value that represents if there has been an error during livness analysis
+	int dumps;                                      // __DUMPS__ if the iterations of liveness analysis are printed
+	CompilationContext& context;                    // Compilation the analysed program belongs to
 	Variables& reg_vars;                            // List of register variables
 	Variables& mem_vars;                            // List of memory variables
-	Variables vars;                                 // List of variables that gets filled when a variable gets assigned a register
-	Instructions& instrs;                           // List of instructions
-	typedef std::vector<std::vector<int>> Matrix;   // Matrix type defined  to represent the interference graph
-	Matrix interferenceGraph;                       // Interference graph
+	Variables& label_vars;                          // List of labels
+	Variables& extern_vars;                         // List of memory variables declared in other modules
+	std::vector<int>& label_positions;              // Positions of labeled instructions by the ids of their labels
+	Instructions& instrs;                           // Instructions of the program
+	std::vector<std::unique_ptr<Function>> functions; // Functions of the program in source order
+	AllocationCache* cache;                         // Results of functions analysed by earlier compilations (or nullptr)
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include "Module.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "Constants.h"
+
+using namespace std;
+
+
+bool Module::read(const string& fileName)
+{
+	ifstream file(fileName);
+	if (!file.is_open())
+		return false;
+
+	*this = Module();
+	string line;
+	if (!getline(file, line) || line != "MAVN module " + to_string(MODULE_VERSION))
+		return false;
+
+	while (getline(file, line))
+	{
+		// everything after a function header is its assembly, up to the next function
+		if (!functions.empty() && line.compare(0, 5, "func ") != 0)
+		{
+			functions.back().lines.push_back(line);
+			continue;
+		}
+
+		istringstream record(line);
+		string kind, name;
+		record >> kind >> name;
+		if (kind == "mem")
+		{
+			int value;
+			record >> value;
+			memory.push_back({ name, value });
+		}
+		else if (kind == "label")
+		{
+			labels.push_back(name);
+		}
+		else if (kind == "import")
+		{
+			string what = name;
+			record >> name;
+			if (what == "label")
+				externLabels.push_back(name);
+			else if (what == "mem")
+				externMemory.push_back(name);
+			else
+				return false;
+		}
+		else if (kind == "func")
+		{
+			functions.push_back({ name, {} });
+		}
+		else
+		{
+			return false;
+		}
+		if (record.fail())
+			return false;
+	}
+	return true;
+}
+
+
+void Module::write(const string& fileName) const
+{
+	ofstream file(fileName);
+	if (!file.is_open())
+		throw runtime_error("\nException! Wasn\'t able to create the module file!");
+
+	file << "MAVN module " << MODULE_VERSION << "\n";
+	for (const Memory& m : memory)
+		file << "mem " << m.name << ' ' << m.value << "\n";
+	for (const string& label : labels)
+		file << "label " << label << "\n";
+	for (const string& label : externLabels)
+		file << "import label " << label << "\n";
+	for (const string& name : externMemory)
+		file << "import mem " << name << "\n";
+
+	for (const Function& function : functions)
+	{
+		file << "func " << function.name << "\n";
+		for (const string& line : function.lines)
+			file << line << "\n";
+	}
+}
@@ -0,0 +1,62 @@
+#ifndef __MODULE__
+#define __MODULE__
+
+#include <string>
+#include <vector>
+
+/**
+ * Relocatable result of compiling one MAVN file, several modules are linked into one program.
+ *
+ * Functions are kept as assembly with their registers already allocated, everything else
+ * they refer to is kept by name: functions and memory variables are exported to the other
+ * modules, labels inside functions are local to the module and the labels and memory variables
+ * the module uses but doesn't define are resolved by the link step.
+ *
+ * The file is text, one record per line:
+ *   MAVN module <version>
+ *   mem <name> <value>       exported memory variable
+ *   label <name>             local label
+ *   import label <name>      label (function) defined in another module
+ *   import mem <name>        memory variable declared in another module
+ *   func <name>              exported function, followed by the lines of its assembly
+ */
+struct Module
+{
+	/**
+	 * Function with its assembly, the lines don't include its label and the return
+	 */
+	struct Function
+	{
+		std::string name;                   // Name of the function
+		std::vector<std::string> lines;     // Lines of assembly of the function body
+	};
+
+	/**
+	 * Memory variable with its initial value
+	 */
+	struct Memory
+	{
+		std::string name;                   // Name of the variable
+		int value;                          // Initial value
+	};
+
+	/**
+	 * Reads a module from a file
+	 * [in]  fileName - path of the module
+	 * [out] return   - false if the file can't be opened or isn't a module of this version
+	 */
+	bool read(const std::string& fileName);
+	/**
+	 * Writes the module into a file
+	 * [in] fileName - path of the module
+	 */
+	void write(const std::string& fileName) const;
+
+	std::vector<Function> functions;        // Exported functions in source order
+	std::vector<Memory> memory;             // Exported memory variables in source order
+	std::vector<std::string> labels;        // Local labels
+	std::vector<std::string> externLabels;  // Labels used but not defined
+	std::vector<std::string> externMemory;  // Memory variables used but not declared
+};
+
+#endif
@@ -0,0 +1,247 @@
+#include "SourceBuffer.h"
+
+#include <cstring>
+#include <cerrno>
+#include <climits>
+#include <algorithm>
+
+#include "Constants.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+
+SourceBuffer::~SourceBuffer()
+{
+	close();
+}
+
+
+bool SourceBuffer::open(const string& fileName)
+{
+	close();
+
+	if (fileName != "-" && map(fileName))
+		return true;
+
+	return openStream(fileName);
+}
+
+
+void SourceBuffer::borrow(const char* source, size_t length)
+{
+	close();
+
+	if (length == 0)
+		return;
+
+	mappedData = source;
+	mappedSize = length;
+	borrowed = true;
+}
+
+
+#ifdef _WIN32
+
+bool SourceBuffer::map(const string& fileName)
+{
+	HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+		FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER length;
+	if (GetFileType(file) != FILE_TYPE_DISK || !GetFileSizeEx(file, &length) || length.QuadPart == 0
+		|| (unsigned long long)length.QuadPart > (size_t)-1)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE fileMapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(file);
+	if (fileMapping == NULL)
+		return false;
+
+	void* view = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+	if (view == NULL)
+	{
+		CloseHandle(fileMapping);
+		return false;
+	}
+
+	mapping = fileMapping;
+	mappedData = (const char*)view;
+	mappedSize = (size_t)length.QuadPart;
+	return true;
+}
+
+
+void SourceBuffer::close()
+{
+	if (mappedData != nullptr && !borrowed)
+	{
+		UnmapViewOfFile(mappedData);
+		CloseHandle((HANDLE)mapping);
+	}
+	closeStream();
+	mappedData = nullptr;
+	mappedSize = 0;
+	mapping = nullptr;
+	borrowed = false;
+	streamed = false;
+	vector<char>().swap(copiedData);
+}
+
+
+bool SourceBuffer::openStream(const string& fileName)
+{
+	if (fileName == "-")
+	{
+		streamHandle = _dup(0);
+		if (streamHandle >= 0)
+			_setmode(streamHandle, _O_BINARY);
+	}
+	else
+	{
+		streamHandle = _open(fileName.c_str(), _O_RDONLY | _O_BINARY | _O_SEQUENTIAL);
+	}
+	streamed = streamHandle >= 0;
+	return streamed;
+}
+
+
+void SourceBuffer::closeStream()
+{
+	if (streamHandle >= 0)
+		_close(streamHandle);
+	streamHandle = -1;
+}
+
+
+size_t SourceBuffer::readStream(char* destination, size_t length)
+{
+	int count = _read(streamHandle, destination, (unsigned)min<size_t>(length, INT_MAX));
+	return count > 0 ? (size_t)count : 0;
+}
+
+#else
+
+bool SourceBuffer::map(const string& fileName)
+{
+	int fd = ::open(fileName.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size == 0
+		|| (unsigned long long)info.st_size > (size_t)-1)
+	{
+		::close(fd);
+		return false;
+	}
+
+	size_t length = (size_t)info.st_size;
+	void* view = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (view == MAP_FAILED)
+		return false;
+
+	// the lexer reads the file front to back exactly once
+	madvise(view, length, MADV_SEQUENTIAL);
+
+	mappedData = (const char*)view;
+	mappedSize = length;
+	return true;
+}
+
+
+void SourceBuffer::close()
+{
+	if (mappedData != nullptr && !borrowed)
+		munmap((void*)mappedData, mappedSize);
+	closeStream();
+	mappedData = nullptr;
+	mappedSize = 0;
+	mapping = nullptr;
+	borrowed = false;
+	streamed = false;
+	vector<char>().swap(copiedData);
+}
+
+
+bool SourceBuffer::openStream(const string& fileName)
+{
+	streamHandle = fileName == "-" ? dup(STDIN_FILENO) : ::open(fileName.c_str(), O_RDONLY);
+	streamed = streamHandle >= 0;
+	return streamed;
+}
+
+
+void SourceBuffer::closeStream()
+{
+	if (streamHandle >= 0)
+		::close(streamHandle);
+	streamHandle = -1;
+}
+
+
+size_t SourceBuffer::readStream(char* destination, size_t length)
+{
+	while (true)
+	{
+		ssize_t count = read(streamHandle, destination, length);
+		if (count >= 0)
+			return (size_t)count;
+		if (errno != EINTR)
+			return 0;
+	}
+}
+
+#endif
+
+
+bool SourceBuffer::refill(size_t keepFrom)
+{
+	if (streamHandle < 0)
+		return false;
+
+	size_t kept = copiedData.size() - keepFrom;
+	if (keepFrom > 0)
+		memmove(copiedData.data(), copiedData.data() + keepFrom, kept);
+
+	size_t capacity = max<size_t>(copiedData.capacity(), STREAM_BUFFER_SIZE);
+	if (kept == capacity)
+		capacity *= 2;
+	copiedData.resize(capacity);
+
+	size_t count = readStream(copiedData.data() + kept, capacity - kept);
+	copiedData.resize(kept + count);
+
+	if (count == 0)
+	{
+		// end of the stream, what is in the buffer now is all there is
+		closeStream();
+	}
+	return true;
+}
+
+
+void SourceBuffer::readToEnd()
+{
+	while (refill(0))
+	{
+	}
+}
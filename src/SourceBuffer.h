@@ -0,0 +1,124 @@
+#ifndef __SOURCE_BUFFER__
+#define __SOURCE_BUFFER__
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+/**
+ * Read-only contents of a program source file.
+ *
+ * Regular files are memory mapped, so the lexer reads straight from the page cache and the
+ * program is never copied. Anything that can not be mapped (the standard input, pipes,
+ * character devices, or a failed mapping) is streamed: only a window of the input is kept
+ * in an owned buffer of STREAM_BUFFER_SIZE characters, which the lexer refills as it goes.
+ * A buffer can also borrow a part of another one, so that the part can be lexed on its own.
+ */
+class SourceBuffer
+{
+public:
+	SourceBuffer() : mappedData(nullptr), mappedSize(0), mapping(nullptr), borrowed(false),
+		streamHandle(-1), streamed(false) {}
+	~SourceBuffer();
+
+	SourceBuffer(const SourceBuffer&) = delete;
+	SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+	/**
+	 * Opens the file and makes its contents available, replacing anything opened before
+	 * [in]  fileName - path of the file, "-" for the standard input
+	 * [out] return   - false if the file could not be opened
+	 */
+	bool open(const std::string& fileName);
+
+	/**
+	 * Makes characters owned by someone else available, replacing anything opened before
+	 * [in] source - first character, must outlive the buffer
+	 * [in] length - number of characters
+	 */
+	void borrow(const char* source, size_t length);
+
+	/**
+	 * Releases the mapping or the owned buffer
+	 */
+	void close();
+
+	/**
+	 * Reads more of a streamed source. Characters before keepFrom are dropped and the rest is
+	 * moved to the front of the buffer, so offsets into the buffer have to be moved back by
+	 * keepFrom and pointers into it are no longer valid. The buffer only grows if the kept
+	 * characters fill it completely (a token longer than the buffer).
+	 * [in]  keepFrom - first character that is still needed
+	 * [out] return   - false if there is nothing more to read (nothing was dropped either)
+	 */
+	bool refill(size_t keepFrom);
+
+	/**
+	 * Reads the rest of a streamed source into the buffer without dropping anything,
+	 * after this the contents stay in place until the buffer is closed
+	 */
+	void readToEnd();
+
+	/**
+	 * Returns a pointer to the first character of the source
+	 */
+	const char* data() const
+	{
+		return mappedData != nullptr ? mappedData : copiedData.data();
+	}
+
+	/**
+	 * Returns the number of characters in the source
+	 */
+	size_t size() const
+	{
+		return mappedData != nullptr ? mappedSize : copiedData.size();
+	}
+
+	/**
+	 * Returns true if the source is a memory mapped file
+	 */
+	bool isMapped() const
+	{
+		return mappedData != nullptr && !borrowed;
+	}
+
+	/**
+	 * Returns true if the source is streamed, so its contents are moved by refill
+	 */
+	bool isStream() const
+	{
+		return streamed;
+	}
+
+private:
+	/**
+	 * Tries to map a regular file, returns false if the file has to be read instead
+	 */
+	bool map(const std::string& fileName);
+
+	/**
+	 * Opens the file (or the standard input) for reading it sequentially, nothing is read yet
+	 */
+	bool openStream(const std::string& fileName);
+
+	/**
+	 * Reads at most length characters of the stream, returns 0 at its end
+	 */
+	size_t readStream(char* destination, size_t length);
+
+	/**
+	 * Closes the file descriptor of a streamed source
+	 */
+	void closeStream();
+
+	const char* mappedData;          // Start of the mapped file, nullptr if the source is copied
+	size_t mappedSize;               // Size of the mapped file
+	void* mapping;                   // Mapping handle (only used on Windows)
+	bool borrowed;                   // True if mappedData belongs to someone else
+	int streamHandle;                // File descriptor of a streamed source, -1 once it has ended
+	bool streamed;                   // True if the source is streamed
+	std::vector<char> copiedData;    // Window of a streamed source
+};
+
+#endif
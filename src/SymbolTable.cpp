@@ -0,0 +1,39 @@
+#include "SymbolTable.h"
+
+#include <cstring>
+#include <algorithm>
+
+#include "Constants.h"
+
+using namespace std;
+
+
+unsigned SymbolTable::intern(string_view name)
+{
+	unordered_map<string_view, unsigned>::iterator found = ids.find(name);
+	if (found != ids.end())
+		return found->second;
+
+	string_view stored = store(name);
+	unsigned symbol = (unsigned)names.size();
+	names.push_back(stored);
+	ids.emplace(stored, symbol);
+	return symbol;
+}
+
+
+string_view SymbolTable::store(string_view name)
+{
+	if (blockSize - blockUsed < name.size())
+	{
+		blockSize = max<size_t>(SYMBOL_BLOCK_SIZE, name.size());
+		blocks.emplace_back(new char[blockSize]);
+		blockUsed = 0;
+	}
+
+	char* destination = blocks.back().get() + blockUsed;
+	if (!name.empty())
+		memcpy(destination, name.data(), name.size());
+	blockUsed += name.size();
+	return string_view(destination, name.size());
+}
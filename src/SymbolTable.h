@@ -0,0 +1,58 @@
+#ifndef __SYMBOL_TABLE__
+#define __SYMBOL_TABLE__
+
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+/**
+ * Intern pool of identifier names. Every distinct name is stored once and gets a dense
+ * symbol number (0, 1, 2, ...), so names can be compared and looked up as integers.
+ * Stored names never move, views returned by getName stay valid as long as the table.
+ */
+class SymbolTable
+{
+public:
+	SymbolTable() : blockUsed(0), blockSize(0) {}
+
+	SymbolTable(const SymbolTable&) = delete;
+	SymbolTable& operator=(const SymbolTable&) = delete;
+
+	/**
+	 * Returns the symbol of the name, adding the name to the table if it isn't in it yet
+	 * [in]  name   - identifier name, it is copied into the table
+	 * [out] return - symbol of the name
+	 */
+	unsigned intern(std::string_view name);
+
+	/**
+	 * Returns the name of the symbol
+	 */
+	std::string_view getName(unsigned symbol) const
+	{
+		return names[symbol];
+	}
+
+	/**
+	 * Returns the number of symbols
+	 */
+	size_t size() const
+	{
+		return names.size();
+	}
+
+private:
+	/**
+	 * Copies the name into the current block of characters (starting a new one if needed)
+	 */
+	std::string_view store(std::string_view name);
+
+	std::vector<std::string_view> names;                  // Names by symbol, point into blocks
+	std::unordered_map<std::string_view, unsigned> ids;   // Symbols by name
+	std::vector<std::unique_ptr<char[]>> blocks;          // Storage of the names
+	size_t blockUsed;                                     // Characters used in the last block
+	size_t blockSize;                                     // Size of the last block
+};
+
+#endif
@@ -3,43 +3,465 @@
  * Datum: 29. 05. 2024.
  */
 
+#include <thread>
+#include <memory>
+#include <cstring>
+#include <cctype>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
 #include "SyntaxAnalysis.h"
+#include "IRImage.h"
+
+SyntaxAnalysis::SyntaxAnalysis(LexicalAnalysis& lexer, bool pullTokens) :
+	lex(lexer), context(lexer.getContext()), tokens(lexer.getTokenList()), symbols(context.getSymbols()), currentToken(0),
+	pull(pullTokens), lookahead(), lookaheadHead(0), lookaheadCount(0),
+	variablePool(context.getVariablePool()),
+	instrs(), reg_vars(context.getArena()), mem_vars(context.getArena()),
+	label_vars(context.getArena()), const_vars(context.getArena()),
+	reg_index(), mem_index(), label_index(), label_positions(), const_pool(),
+	err(false), eof(false), next_instruction_has_label(false),
+	partial(false), lexicalError(false), messages(), unresolved_vars(context.getArena()), unresolved_index(), deferred(),
+	module(false), extern_vars(context.getArena()), extern_index() {}
 
-SyntaxAnalysis::SyntaxAnalysis(LexicalAnalysis& lexer) :
-	lex(lexer), currentToken(lexer.getTokenList().begin()),
-	instrs(), reg_vars(), mem_vars(), label_vars(), const_vars(),
-	err(false), eof(false), next_instruction_has_label(false) {}
-SyntaxAnalysis::~SyntaxAnalysis()
+bool SyntaxAnalysis::Do()
 {
-	for (Variables::iterator it = reg_vars.begin(); it != reg_vars.end(); ++it)
-		delete* it;
-	for (Variables::iterator it = mem_vars.begin(); it != mem_vars.end(); ++it)
-		delete* it;
-	for (Variables::iterator it = label_vars.begin(); it != label_vars.end(); ++it)
-		delete* it;
-	for (Variables::iterator it = const_vars.begin(); it != const_vars.end(); ++it)
-		delete* it;
-	for (Instructions::iterator it = instrs.begin(); it != instrs.end(); ++it)
-		delete* it;
+	currentToken = 0;
+	lookaheadHead = 0;
+	lookaheadCount = 0;
+
+	Q();
+	checkLabels();
+	checkFunctions();
+
+	return !err;
 }
 
-bool SyntaxAnalysis::Do()
+bool SyntaxAnalysis::DoModule()
 {
-	currentToken = lex.getTokenList().begin();
+	module = true;
+	return Do();
+}
+
+bool SyntaxAnalysis::DoParallelModule()
+{
+	module = true;
+	return DoParallel();
+}
+
+bool SyntaxAnalysis::DoParallel()
+{
+	lex.bufferWholeInput();
+	const SourceBuffer& source = lex.getProgramBuffer();
+	size_t parts = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()),
+		source.size() / PARALLEL_PARSE_CHUNK_SIZE);
+	std::vector<size_t> bounds = splitSource(source.data(), source.size(), parts);
+	parts = bounds.size() - 1;
+	if (parts < 2)
+	{
+		// the tokens weren't read beforehand, so they are pulled from the lexer
+		if (tokens.empty())
+			pull = true;
+		return Do();
+	}
+
+	// lex and parse every part on its own, errors are kept until the merge
+	std::vector<std::unique_ptr<CompilationContext>> contexts;
+	std::vector<std::unique_ptr<LexicalAnalysis>> lexers;
+	std::vector<std::unique_ptr<SyntaxAnalysis>> parsers;
+	std::vector<std::exception_ptr> failures(parts);
+	std::vector<std::thread> workers;
+	for (size_t part = 0; part < parts; ++part)
+	{
+		contexts.emplace_back(new CompilationContext());
+		lexers.emplace_back(new LexicalAnalysis(*contexts.back()));
+		lexers.back()->readInputBuffer(source.data() + bounds[part], bounds[part + 1] - bounds[part]);
+		lexers.back()->initialize();
+		parsers.emplace_back(new SyntaxAnalysis(*lexers.back(), true));
+		parsers.back()->partial = true;
+	}
+	for (size_t part = 0; part < parts; ++part)
+	{
+		workers.emplace_back([this, &parsers, &failures, part]()
+		{
+			try
+			{
+				// parts after the first one start right after a statement
+				if (part == 0 || !parsers[part]->L())
+					parsers[part]->Q();
+			}
+			catch (...)
+			{
+				parsers[part]->err = true;
+				failures[part] = std::current_exception();
+			}
+		});
+	}
+	for (std::thread& worker : workers)
+		worker.join();
+
+	// the variables of the parts stay in the contexts of the parts
+	for (size_t part = 0; part < parts; ++part)
+		context.adopt(std::move(contexts[part]));
+
+	// merge the parts in program order, so that the first error found is the first one in the program
+	std::unordered_map<std::string_view, Variable*> regs, mems, labels, externs;
+	std::unordered_map<int, Variable*> consts;
+	std::unordered_map<Variable*, Variable*> replacements;
+	std::vector<size_t> firstInstruction;
+	for (size_t part = 0; part < parts; ++part)
+	{
+		SyntaxAnalysis& syn = *parsers[part];
+		firstInstruction.push_back(instrs.size());
+		for (const DeferredCheck& check : syn.deferred)
+		{
+			Variable* var = check.var;
+			std::unordered_map<std::string_view, Variable*>& declared =
+				var->getType() == Variable::REG_VAR ? regs : var->getType() == Variable::MEM_VAR ? mems : labels;
+			std::unordered_map<std::string_view, Variable*>::iterator found = declared.find(var->getName());
+			if (check.declaration && found != declared.end())
+			{
+				err = true;
+				switch (var->getType())
+				{
+				case Variable::REG_VAR:
+					std::cerr << "Register variable with the same name already exists!" << std::endl;
+					throw REGISTER_VAR_EXISTS;
+				case Variable::MEM_VAR:
+					std::cerr << "Memory variable with the same name already exists!" << std::endl;
+					throw MEMORY_VAR_EXISTS;
+				default:
+					std::cerr << "Label with the same name already exists!" << std::endl;
+					throw LABEL_EXISTS;
+				}
+			}
+			if (!check.declaration && found == declared.end() && module && var->getType() == Variable::MEM_VAR)
+			{
+				// the variable is declared in another module, which is checked when linking
+				Variable*& existing = externs[var->getName()];
+				if (existing != nullptr)
+				{
+					replacements[var] = existing;
+				}
+				else
+				{
+					existing = var;
+					extern_vars.push_back(var);
+				}
+				continue;
+			}
+			if (!check.declaration && found == declared.end())
+			{
+				err = true;
+				std::cerr << "Variable not found!" << std::endl;
+				throw VARIABLE_DOESNT_EXIST;
+			}
+			if (check.declaration)
+				declared[var->getName()] = var;
+			else
+				replacements[var] = found->second;
+		}
+		if (failures[part])
+		{
+			err = true;
+			std::cerr << syn.messages.str();
+			if (syn.lexicalError)
+				syn.lex.printLexError();
+			std::rethrow_exception(failures[part]);
+		}
+
+		// the same constant is kept only once
+		for (Variable* var : syn.const_vars)
+		{
+			Variable*& existing = consts[var->getValue()];
+			if (existing != nullptr)
+			{
+				replacements[var] = existing;
+			}
+			else
+			{
+				existing = var;
+				const_vars.push_back(var);
+			}
+		}
+		// placeholders of labels defined later stay with the part until all the parts are merged
+		for (Variables::iterator it = syn.label_vars.begin(); it != syn.label_vars.end();)
+		{
+			if ((*it)->getValue() == 1)
+			{
+				label_vars.push_back(*it);
+				it = syn.label_vars.erase(it);
+			}
+			else
+				++it;
+		}
+		// the lists of the parts take their nodes from other arenas, so they are copied instead of spliced,
+		// the instructions still refer to the variables by their ids in the contexts of the parts
+		reg_vars.insert(reg_vars.end(), syn.reg_vars.begin(), syn.reg_vars.end());
+		mem_vars.insert(mem_vars.end(), syn.mem_vars.begin(), syn.mem_vars.end());
+		instrs.insert(instrs.end(), syn.instrs.begin(), syn.instrs.end());
+	}
+	for (size_t part = 0; part < parts; ++part)
+	{
+		SyntaxAnalysis& syn = *parsers[part];
+		for (Variables::iterator it = syn.label_vars.begin(); it != syn.label_vars.end();)
+		{
+			Variable*& existing = labels[(*it)->getName()];
+			if (existing != nullptr)
+			{
+				replacements[*it] = existing;
+				++it;
+			}
+			else
+			{
+				// jumps to a label that doesn't exist, reported by checkLabels
+				existing = *it;
+				label_vars.push_back(*it);
+				it = syn.label_vars.erase(it);
+			}
+		}
+	}
+
+	// the names are moved from the symbol tables of the parts and the variables get ids in this context
+	for (Variables* vars : { &reg_vars, &mem_vars, &label_vars, &const_vars, &extern_vars })
+		for (Variable* var : *vars)
+		{
+			unsigned symbol = symbols.intern(var->getName());
+			var->setSymbol(symbol, symbols.getName(symbol));
+			var->setId(context.addVariable(var));
+		}
+
+	// point the instructions to the merged variables and number the register variables in program order
+	firstInstruction.push_back(instrs.size());
+	for (size_t part = 0; part < parts; ++part)
+	{
+		CompilationContext& partContext = parsers[part]->context;
+		auto merged = [&partContext, &replacements](int id)
+		{
+			Variable* var = partContext.getVariable(id);
+			std::unordered_map<Variable*, Variable*>::iterator found = replacements.find(var);
+			return (found != replacements.end() ? found->second : var)->getId();
+		};
+		for (size_t i = firstInstruction[part]; i < firstInstruction[part + 1]; ++i)
+		{
+			if (instrs[i].getLabel() != NO_VARIABLE)
+			{
+				instrs[i].addLabel(merged(instrs[i].getLabel()));
+				indexLabelPosition((int)i);
+			}
+			for (int o = 0; o < instrs[i].getNumOfOperands(); ++o)
+				instrs[i].getOperand(o) = merged(instrs[i].getOperand(o));
+		}
+	}
+	int position = 0;
+	for (Variable* var : reg_vars)
+		var->setPos(position++);
 
-	Q();
 	checkLabels();
 	checkFunctions();
 
 	return !err;
 }
 
+void SyntaxAnalysis::writeImage(const std::string& fileName)
+{
+	ImageHeader header = {};
+	memcpy(header.magic, IR_IMAGE_MAGIC, sizeof(header.magic));
+	header.version = IR_IMAGE_VERSION;
+
+	// variables get their indices in the order of their lists
+	Variables* lists[] = { &reg_vars, &mem_vars, &label_vars, &const_vars, &extern_vars };
+	uint32_t* counts[] = { &header.numOfRegs, &header.numOfMems, &header.numOfLabels, &header.numOfConsts, &header.numOfExterns };
+	std::unordered_map<int, int32_t> indices;
+	std::vector<ImageVariable> variables;
+	std::string names;
+	for (int list = 0; list < 5; ++list)
+	{
+		*counts[list] = (uint32_t)lists[list]->size();
+		for (Variable* var : *lists[list])
+		{
+			indices[var->getId()] = (int32_t)variables.size();
+			variables.push_back({ (uint32_t)names.size(), (uint32_t)var->getName().size(), var->getValue() });
+			names += var->getName();
+		}
+	}
+	header.sizeOfNames = (uint32_t)names.size();
+
+	std::vector<ImageInstruction> code;
+	for (Instruction& i : instrs)
+	{
+		ImageInstruction record;
+		record.type = i.getType();
+		record.label = i.getLabel() != NO_VARIABLE ? indices.at(i.getLabel()) : -1;
+		for (int o = 0; o < MAX_OPERANDS; ++o)
+			record.operands[o] = o < i.getNumOfOperands() ? indices.at(i.getOperand(o)) : -1;
+		code.push_back(record);
+	}
+	header.numOfInstructions = (uint32_t)code.size();
+
+	std::ofstream file(fileName, std::ios::binary);
+	if (!file.is_open())
+		throw std::runtime_error("\nException! Wasn\'t able to create the IR image!");
+	file.write((const char*)&header, sizeof(header));
+	file.write((const char*)variables.data(), variables.size() * sizeof(ImageVariable));
+	file.write((const char*)code.data(), code.size() * sizeof(ImageInstruction));
+	file.write(names.data(), names.size());
+}
+
+bool SyntaxAnalysis::readImage(const std::string& fileName)
+{
+	SourceBuffer image;
+	if (!image.open(fileName))
+		return false;
+	if (image.isStream())
+		image.readToEnd();
+
+	ImageHeader header;
+	if (image.size() < sizeof(header))
+		return false;
+	memcpy(&header, image.data(), sizeof(header));
+	if (memcmp(header.magic, IR_IMAGE_MAGIC, sizeof(header.magic)) != 0 || header.version != IR_IMAGE_VERSION)
+		return false;
+
+	uint32_t counts[] = { header.numOfRegs, header.numOfMems, header.numOfLabels, header.numOfConsts, header.numOfExterns };
+	uint64_t numOfVariables = 0;
+	for (uint32_t count : counts)
+		numOfVariables += count;
+	if (image.size() != sizeof(header) + numOfVariables * sizeof(ImageVariable) +
+		(uint64_t)header.numOfInstructions * sizeof(ImageInstruction) + header.sizeOfNames)
+		return false;
+	const char* variables = image.data() + sizeof(header);
+	const char* code = variables + numOfVariables * sizeof(ImageVariable);
+	const char* names = code + (size_t)header.numOfInstructions * sizeof(ImageInstruction);
+
+	// the records are copied out of the image, which doesn't have to be aligned, names are written
+	// into the assembly, so they have to be identifiers that are unique in their kind (constants are written by value)
+	enum { REGS, MEMS, LABELS, CONSTS, EXTERNS, END };
+	Variables* lists[] = { &reg_vars, &mem_vars, &label_vars, &const_vars, &extern_vars };
+	Variable::VariableType types[] = { Variable::REG_VAR, Variable::MEM_VAR, Variable::LABEL_VAR, Variable::CONST_VAR, Variable::MEM_VAR };
+	int64_t first[END + 1] = { 0 };
+	std::unordered_set<unsigned> regNames, memNames, labelNames;
+	std::unordered_set<unsigned>* namesOf[] = { &regNames, &memNames, &labelNames, nullptr, &memNames };
+	std::vector<int> ids;
+	for (int list = REGS; list < END; ++list)
+	{
+		first[list] = (int64_t)ids.size();
+		for (uint32_t k = 0; k < counts[list]; ++k)
+		{
+			ImageVariable record;
+			memcpy(&record, variables + ids.size() * sizeof(ImageVariable), sizeof(record));
+			if ((uint64_t)record.nameOffset + record.nameLength > header.sizeOfNames || record.nameLength == 0)
+				return false;
+			std::string_view name(names + record.nameOffset, record.nameLength);
+			for (char c : name)
+				if (list != CONSTS && !isalnum((unsigned char)c) && c != '_')
+					return false;
+			unsigned symbol = symbols.intern(name);
+			if (namesOf[list] != nullptr && !namesOf[list]->insert(symbol).second)
+				return false;
+			Variable* var = variablePool.create(context, types[list], symbol, symbols.getName(symbol), record.value);
+			lists[list]->push_back(var);
+			ids.push_back(var->getId());
+		}
+	}
+	first[END] = (int64_t)ids.size();
+	int position = 0;
+	for (Variable* var : reg_vars)
+		var->setPos(position++);
+
+	// every operand has to be a variable of the kind its instruction expects, which is what the liveness analysis
+	// relies on and what is written into the assembly
+	auto isIn = [&first](int32_t index, int list) { return index >= first[list] && index < first[list + 1]; };
+	std::vector<int> placed(header.numOfLabels, 0);
+	instrs.reserve(header.numOfInstructions);
+	for (uint32_t n = 0; n < header.numOfInstructions; ++n)
+	{
+		ImageInstruction record;
+		memcpy(&record, code + (size_t)n * sizeof(ImageInstruction), sizeof(record));
+		if (record.type < 0 || record.type >= NUM_OF_INSTRUCTIONS || (record.label != -1 && !isIn(record.label, LABELS)) ||
+			(record.type == I_NO_TYPE && record.label == -1))
+			return false;
+		if (record.label != -1)
+			++placed[record.label - first[LABELS]];
+		Instruction i((InstructionType)record.type, record.label != -1 ? ids[record.label] : NO_VARIABLE);
+		for (int o = 0; o < i.getNumOfOperands(); ++o)
+		{
+			int32_t operand = record.operands[o];
+			bool valid = false;
+			switch (i.getOperandKind(o))
+			{
+			case O_DST:
+			case O_SRC:		valid = isIn(operand, REGS); break;
+			case O_MEM:		valid = isIn(operand, MEMS) || isIn(operand, EXTERNS); break;
+			case O_LABEL:	valid = isIn(operand, LABELS); break;
+			case O_CONST:	valid = isIn(operand, CONSTS); break;
+			default:		break;
+			}
+			if (!valid)
+				return false;
+			i.addOperand(ids[operand]);
+		}
+		addInstruction(i);
+	}
+
+	// a label defined in the program is on exactly one instruction, the others are defined in other modules
+	for (int k = 0; k < (int)placed.size(); ++k)
+		if (placed[k] != (context.getVariable(ids[first[LABELS] + k])->getValue() == 1 ? 1 : 0))
+			return false;
+
+	// the same checks as after syntax analysis, a register variable of two functions would be allocated twice
+	try
+	{
+		checkFunctions();
+	}
+	catch (SyntaxError)
+	{
+		return false;
+	}
+	return true;
+}
+
+std::vector<size_t> SyntaxAnalysis::splitSource(const char* source, size_t length, size_t parts)
+{
+	std::vector<size_t> bounds(1, 0);
+	for (size_t part = 1; part < parts; ++part)
+	{
+		size_t pos = std::max(length / parts * part, bounds.back());
+
+		// a line can't begin inside a comment
+		const char* lineEnd = (const char*)memchr(source + pos, '\n', length - pos);
+		if (lineEnd == nullptr)
+			break;
+		pos = (size_t)(lineEnd - source) + 1;
+
+		while (pos < length && source[pos] != ';')
+		{
+			if (source[pos] == '/' && pos + 1 < length && source[pos + 1] == '/')
+			{
+				lineEnd = (const char*)memchr(source + pos, '\n', length - pos);
+				pos = lineEnd != nullptr ? (size_t)(lineEnd - source) : length;
+			}
+			else
+			{
+				++pos;
+			}
+		}
+		if (pos + 1 >= length)
+			break;
+		bounds.push_back(pos + 1);
+	}
+	bounds.push_back(length);
+	return bounds;
+}
+
 void SyntaxAnalysis::printInstructions()
 {
 	std::cout << ">>>>>======------\n"
 		      << "| Instructions :\n"
 	       	  << ">>>>>======------\n";
-	print(instrs);
+	print(instrs, std::cout);
 }
 void SyntaxAnalysis::printVariables()
 {
@@ -63,6 +485,83 @@ Instructions& SyntaxAnalysis::getInstructions()
 {
 	return instrs;
 }
+Variables& SyntaxAnalysis::getLabels()
+{
+	return label_vars;
+}
+std::vector<int>& SyntaxAnalysis::getLabelPositions()
+{
+	return label_positions;
+}
+Variables& SyntaxAnalysis::getExterns()
+{
+	return extern_vars;
+}
+CompilationContext& SyntaxAnalysis::getContext()
+{
+	return context;
+}
+
+const Token& SyntaxAnalysis::peek(size_t ahead)
+{
+	while (lookaheadCount <= ahead)
+	{
+		// values of the tokens in the ring aren't used (a streamed input is moved when the lexer
+		// reads more of it), names are taken from the symbol table and numbers from the tokens
+		Token& slot = lookahead[(lookaheadHead + lookaheadCount) % TOKEN_LOOKAHEAD];
+		slot = lex.getNextToken();
+		++lookaheadCount;
+
+		if (slot.getType() == T_ERROR)
+		{
+			err = true;
+			errorStream() << lexicalErrorToString(slot.getError()) << " found while reading tokens!" << std::endl;
+			if (partial)
+				lexicalError = true;
+			else
+				lex.printLexError();
+			throw LEXICAL_ERROR;
+		}
+	}
+	return lookahead[(lookaheadHead + ahead) % TOKEN_LOOKAHEAD];
+}
+TokenType SyntaxAnalysis::currentType()
+{
+	if (pull)
+		return peek().getType();
+	return tokens.getType(currentToken);
+}
+unsigned SyntaxAnalysis::currentSymbol()
+{
+	if (pull)
+		return peek().getSymbol();
+	return tokens.getSymbol(currentToken);
+}
+int SyntaxAnalysis::currentNumber()
+{
+	if (pull)
+		return peek().getNumber();
+	return tokens.getNumber(currentToken);
+}
+void SyntaxAnalysis::advance()
+{
+	if (pull)
+	{
+		peek();
+		lookaheadHead = (lookaheadHead + 1) % TOKEN_LOOKAHEAD;
+		--lookaheadCount;
+	}
+	else
+	{
+		++currentToken;
+	}
+}
+std::ostream& SyntaxAnalysis::errorStream()
+{
+	if (partial)
+		return messages;
+	return std::cerr;
+}
 
 void SyntaxAnalysis::eat(TokenType token)
 {
@@ -71,215 +570,294 @@ void SyntaxAnalysis::eat(TokenType token)
 		eof = true;
 	}
 
-	if (currentToken->getType() == token)
+	if (currentType() == token)
 	{
-		++currentToken;
+		advance();
 	}
 	else {
 		err = true;
-		std::cerr << "Expected token is " <<
+		errorStream() << "Expected token is " <<
 			tokenTypeToString(token) << " but " <<
-			tokenTypeToString(currentToken->getType()) << " was given!" << std::endl;
+			tokenTypeToString(currentType()) << " was given!" << std::endl;
 		throw WRONG_TOKEN;
 	}
 }
 
 void SyntaxAnalysis::glance(TokenType token)
 {
-	if (token != currentToken->getType())
+	if (token != currentType())
 	{
 		err = true;
-		std::cerr << "Wrong token type " <<
-			tokenTypeToString(currentToken->getType()) <<
+		errorStream() << "Wrong token type " <<
+			tokenTypeToString(currentType()) <<
 			", unable to read its contents for conversion!" << std::endl;
 		throw WRONG_TOKEN;
 	}
 }
 
-void SyntaxAnalysis::regVariableExists(std::string& name)
+void SyntaxAnalysis::regVariableExists(unsigned symbol)
 {
-	for (Variables::iterator it = reg_vars.begin(); it != reg_vars.end(); ++it)
+	if (indexedVariable(reg_index, symbol) != nullptr)
 	{
-		if ((*it)->getName() == name)
-		{
-			err = true;
-			std::cerr << "Register variable with the same name already exists!" << std::endl;
-			throw REGISTER_VAR_EXISTS;
-		}
+		err = true;
+		errorStream() << "Register variable with the same name already exists!" << std::endl;
+		throw REGISTER_VAR_EXISTS;
 	}
 }
-void SyntaxAnalysis::memVariableExists(std::string& name)
+void SyntaxAnalysis::memVariableExists(unsigned symbol)
 {
-	for (Variables::iterator it = mem_vars.begin(); it != mem_vars.end(); ++it)
+	if (indexedVariable(mem_index, symbol) != nullptr)
 	{
-		if ((*it)->getName() == name)
-		{
-			err = true;
-			std::cerr << "Memory variable with the same name already exists!" << std::endl;
-			throw MEMORY_VAR_EXISTS;
-		}
+		err = true;
+		errorStream() << "Memory variable with the same name already exists!" << std::endl;
+		throw MEMORY_VAR_EXISTS;
 	}
 }
-void SyntaxAnalysis::labelExists(std::string& name)
+void SyntaxAnalysis::labelExists(unsigned symbol)
 {
-	for (Variables::iterator it = label_vars.begin(); it != label_vars.end(); ++it)
+	Variables::iterator it = indexedLabel(symbol);
+	if (it != label_vars.end() && (*it)->getValue() == 1)
 	{
-		if ((*it)->getName() == name && (*it)->getValue() == 1)
-		{
-			err = true;
-			std::cerr << "Label with the same name already exists!" << std::endl;
-			throw LABEL_EXISTS;
-		}
+		err = true;
+		errorStream() << "Label with the same name already exists!" << std::endl;
+		throw LABEL_EXISTS;
 	}
 }
 
+Variable*& SyntaxAnalysis::indexedVariable(std::vector<Variable*>& index, unsigned symbol)
+{
+	if (symbol >= index.size())
+		index.resize(symbols.size(), nullptr);
+	return index[symbol];
+}
+Variables::iterator& SyntaxAnalysis::indexedLabel(unsigned symbol)
+{
+	if (symbol >= label_index.size())
+		label_index.resize(symbols.size(), label_vars.end());
+	return label_index[symbol];
+}
+void SyntaxAnalysis::addLabel(Variable* label)
+{
+	label_vars.push_back(label);
+	indexedLabel(label->getSymbol()) = std::prev(label_vars.end());
+}
+void SyntaxAnalysis::addInstruction(const Instruction& instruction)
+{
+	instrs.push_back(instruction);
+	if (instruction.getLabel() != NO_VARIABLE)
+		indexLabelPosition((int)instrs.size() - 1);
+}
+void SyntaxAnalysis::indexLabelPosition(int position)
+{
+	int label = instrs[position].getLabel();
+	if (label >= (int)label_positions.size())
+		label_positions.resize(label + 1, -1);
+	label_positions[label] = position;
+}
+
 Variable* SyntaxAnalysis::createVariable()
 {
 	Variable* var;
-	std::string name;
-	switch (currentToken->getType())
+	unsigned symbol = currentSymbol();
+	switch (currentType())
 	{
 	case T_M_ID:
-		name = currentToken->getValue();
-		memVariableExists(name);
+		memVariableExists(symbol);
 		eat(T_M_ID);
 
 		glance(T_NUM);
-		var = new Variable(Variable::MEM_VAR, name, stoi(currentToken->getValue()));
+		var = variablePool.create(context, Variable::MEM_VAR, symbol, symbols.getName(symbol), currentNumber());
 		eat(T_NUM);
 
 		break;
 	case T_R_ID:
-		name = currentToken->getValue();
-		regVariableExists(name);
+		regVariableExists(symbol);
 		eat(T_R_ID);
 
-		var = new Variable(Variable::REG_VAR, name);
+		var = variablePool.create(context, Variable::REG_VAR, symbol, symbols.getName(symbol));
 
 		break;
 	case T_ID:
-		name = currentToken->getValue();
-		labelExists(name);
+	{
+		labelExists(symbol);
 		eat(T_ID);
 
-		var = new Variable(Variable::LABEL_VAR, name, 1);
+		// a label that was jumped to before it was defined already has a placeholder,
+		// it is taken out of the list of labels so that the caller can add it as defined
+		Variables::iterator& position = indexedLabel(symbol);
+		if (position == label_vars.end())
+		{
+			var = variablePool.create(context, Variable::LABEL_VAR, symbol, symbols.getName(symbol), 1);
+		}
+		else
+		{
+			var = *position;
+			var->getValue() = 1;
+			label_vars.erase(position);
+			position = label_vars.end();
+		}
 
 		break;
+	}
 	default:
 		err = true;
-		std::cerr << "Expected a type of an ID token!" << std::endl;
+		errorStream() << "Expected a type of an ID token!" << std::endl;
 		throw WRONG_TOKEN;
 	}
+	if (partial)
+		deferred.push_back({ true, var });
 	return var;
 }
 Variable* SyntaxAnalysis::findVariable()
 {
-	return findVariable(currentToken->getValue());
+	return findVariable(currentSymbol());
 }
 Variable* SyntaxAnalysis::constVariable(int value)
 {
-	return findVariable("c" + std::to_string(value));
+	Variable*& var = const_pool[value];
+	if (var == nullptr)
+	{
+		unsigned symbol = symbols.intern("c" + std::to_string(value));
+		var = variablePool.create(context, Variable::CONST_VAR, symbol, symbols.getName(symbol), value);
+		const_vars.push_back(var);
+	}
+	return var;
 }
-Variable* SyntaxAnalysis::findVariable(std::string& name)
+Variable* SyntaxAnalysis::findVariable(unsigned symbol)
 {
+	std::string_view name = symbols.getName(symbol);
 	switch (name[0])
 	{
 	case 'r':
-		for (Variables::iterator it = reg_vars.begin(); it != reg_vars.end(); ++it)
-			if ((*it)->getName() == name)
-				return *it;
+		if (indexedVariable(reg_index, symbol) != nullptr)
+			return reg_index[symbol];
 		break;
 	case 'm':
-		for (Variables::iterator it = mem_vars.begin(); it != mem_vars.end(); ++it)
-			if ((*it)->getName() == name)
-				return *it;
+		if (indexedVariable(mem_index, symbol) != nullptr)
+			return mem_index[symbol];
 		break;
-	case 'c':
-		for (Variables::iterator it = const_vars.begin(); it != const_vars.end(); ++it)
-			if ((*it)->getName() == name)
-				return *it;
-		Variable* var = new Variable(Variable::CONST_VAR, "c" + name, stoi(name.replace(0, 1, "")));
-		const_vars.push_back(var);
+	}
+	if (partial && (name[0] == 'r' || name[0] == 'm'))
+	{
+		// the variable may be declared in an earlier part of the program, which is checked when merging
+		Variable*& var = indexedVariable(unresolved_index, symbol);
+		if (var == nullptr)
+		{
+			var = variablePool.create(context, name[0] == 'r' ? Variable::REG_VAR : Variable::MEM_VAR, symbol, name);
+			unresolved_vars.push_back(var);
+			deferred.push_back({ false, var });
+		}
+		return var;
+	}
+	if (module && name[0] == 'm')
+	{
+		// the variable is declared in another module, which is checked when linking
+		Variable*& var = indexedVariable(extern_index, symbol);
+		if (var == nullptr)
+		{
+			var = variablePool.create(context, Variable::MEM_VAR, symbol, name);
+			extern_vars.push_back(var);
+		}
 		return var;
 	}
 	err = true;
-	std::cerr << "Variable not found!" << std::endl;
+	errorStream() << "Variable not found!" << std::endl;
 	throw VARIABLE_DOESNT_EXIST;
 }
-Variable* SyntaxAnalysis::findLabel(std::string& name)
+Variable* SyntaxAnalysis::findLabel(unsigned symbol)
 {
-	for (Variables::iterator it = label_vars.begin(); it != label_vars.end(); ++it)
-		if ((*it)->getName() == name)
-			return *it;
-	Variable* var = new Variable(Variable::LABEL_VAR, name, 0);
-	label_vars.push_back(var);
+	Variables::iterator it = indexedLabel(symbol);
+	if (it != label_vars.end())
+		return *it;
+	Variable* var = variablePool.create(context, Variable::LABEL_VAR, symbol, symbols.getName(symbol), 0);
+	addLabel(var);
 	return var;
 }
 
 void SyntaxAnalysis::checkLabels()
 {
 	for (Variables::iterator it = label_vars.begin(); it != label_vars.end(); ++it)
-		if ((*it)->getValue() != 1)
+		if ((*it)->getValue() != 1 && !module)
 		{
 			err = true;
-			std::cerr << "Label: " << (*it)->getName() << " doesn\'t exist!" << std::endl;
+			errorStream() << "Label: " << (*it)->getName() << " doesn\'t exist!" << std::endl;
 			throw LABEL_DOESNT_EXIST;
 		}
 }
 void SyntaxAnalysis::checkFunctions()
 {
-	if (!(instrs.front()->isFunc()))
+	if (instrs.empty() || !instrs.front().isFunc())
 	{
 		err = true;
-		std::cerr << "No beginning!" << std::endl;
+		errorStream() << "No beginning!" << std::endl;
 		throw NO_MAIN_FUNC;
 	}
-	int count = 0;
-	for (Instruction* i : instrs)
-		if (i->isFunc())
-			++count;
-	if (count != 1)
+	// functions that use the register variables by their position
+	std::vector<int> users(reg_vars.size(), -1);
+	int function = -1;
+	for (int i = 0; i < (int)instrs.size(); ++i)
 	{
-		err = true;
-		std::cerr << "There are more than one functions in your program!" << std::endl;
-		throw TOO_MANY_FUNCS;
+		if (instrs[i].isFunc())
+		{
+			function = i;
+			continue;
+		}
+		for (int o = 0; o < instrs[i].getNumOfOperands(); ++o)
+		{
+			Variable* var = context.getVariable(instrs[i].getOperand(o));
+			if (var->getType() != Variable::REG_VAR)
+				continue;
+			int& user = users[var->getPos()];
+			if (user != -1 && user != function)
+			{
+				err = true;
+				errorStream() << "Register variable " << var->getName() << " is used in more than one function!" << std::endl;
+				throw REGISTER_IN_MANY_FUNCS;
+			}
+			user = function;
+		}
 	}
 }
 
 void SyntaxAnalysis::Q()
 {
-	next_instruction_has_label = false;
-	if (currentToken->getType() == T_COMMENT)
-	{
-		eat(T_COMMENT);
-		L();
-	}
-	else
+	// L -> Q is read as the next iteration instead of a recursive call,
+	// so the depth of the stack doesn't grow with the number of statements
+	do
 	{
-		S();
-		eat(T_SEMI_COL);
-		L();
-	}
+		next_instruction_has_label = false;
+		if (currentType() == T_COMMENT)
+		{
+			eat(T_COMMENT);
+		}
+		else
+		{
+			S();
+			eat(T_SEMI_COL);
+		}
+	} while (!L());
 }
 void SyntaxAnalysis::S()
 {
-	switch (currentToken->getType())
+	switch (currentType())
 	{
 	case T_MEM:
 		eat(T_MEM);
 		mem_vars.push_back(createVariable());
+		indexedVariable(mem_index, mem_vars.back()->getSymbol()) = mem_vars.back();
 		break;
 	case T_REG:
 		eat(T_REG);
 		reg_vars.push_back(createVariable());
+		indexedVariable(reg_index, reg_vars.back()->getSymbol()) = reg_vars.back();
 		break;
 	case T_FUNC:
 		eat(T_FUNC);
-		label_vars.push_back(createVariable());
-		instrs.push_back(new Instruction(I_NO_TYPE, label_vars.back()));
+		addLabel(createVariable());
+		addInstruction(Instruction(I_NO_TYPE, label_vars.back()->getId()));
 		break;
 	case T_ID:
-		label_vars.push_back(createVariable());
+		addLabel(createVariable());
 		next_instruction_has_label = true;
 		eat(T_COL);
 		E();
@@ -288,289 +866,58 @@ void SyntaxAnalysis::S()
 		E();
 	}
 }
-void SyntaxAnalysis::L()
+bool SyntaxAnalysis::L()
 {
-	if (currentToken->getType() == T_END_OF_FILE)
-	{
-		eat(T_END_OF_FILE);
-		eof = true;
-	}
-	else
-		Q();
+	if (currentType() != T_END_OF_FILE)
+		return false;
+
+	eat(T_END_OF_FILE);
+	eof = true;
+	return true;
 }
 void SyntaxAnalysis::E()
 {
-	Instruction* i;
-	Variable* src1;
-	Variable* src2;
-	Variable* dst;
-	switch (currentToken->getType())
+	const InstructionDescriptor* descriptor = InstructionSet::find(currentType());
+	if (descriptor == nullptr)
 	{
-	case T_ADD:
-		eat(T_ADD);
-		i = new Instruction(I_ADD);
-
-		glance(T_R_ID);
-		dst = findVariable();
-		eat(T_R_ID);
-		eat(T_COMMA);
-
-		glance(T_R_ID);
-		src1 = findVariable();
-		eat(T_R_ID);
-		eat(T_COMMA);
-
-		glance(T_R_ID);
-		src2 = findVariable();
-		eat(T_R_ID);
-
-		i->addDst(dst);
-		i->addSrc(src1);
-		i->addSrc(src2);
-		break;
-	case T_ADDI:
-		eat(T_ADDI);
-		i = new Instruction(I_ADDI);
-
-		glance(T_R_ID);
-		dst = findVariable();
-		eat(T_R_ID);
-		eat(T_COMMA);
-
-		glance(T_R_ID);
-		src1 = findVariable();
-		eat(T_R_ID);
-		eat(T_COMMA);
-
-		glance(T_NUM);
-		src2 = constVariable(stoi(currentToken->getValue()));
-		eat(T_NUM);
-
-		i->addDst(dst);
-		i->addSrc(src1);
-		i->addSrc(src2);
-		break;
-	case T_B:
-		eat(T_B);
-		i = new Instruction(I_B);
-		
-		glance(T_ID);
-		src1 = findLabel(currentToken->getValue());
-		eat(T_ID);
-	
-		i->addSrc(src1);
-		break;
-	case T_BLTZ:
-		eat(T_BLTZ);
-		i = new Instruction(I_BLTZ);
-
-		glance(T_R_ID);
-		src1 = findVariable();
-		eat(T_R_ID);
-		eat(T_COMMA);
-
-		glance(T_ID);
-		src2 = findLabel(currentToken->getValue());
-		eat(T_ID);
-
-		i->addSrc(src1);
-		i->addSrc(src2);
-		break;
-	case T_LA:
-		eat(T_LA);
-		i = new Instruction(I_LA);
-
-		glance(T_R_ID);
-		dst = findVariable();
-		eat(T_R_ID);
-		eat(T_COMMA);
-
-		glance(T_M_ID);
-		src1 = findVariable();
-		eat(T_M_ID);
-
-		i->addDst(dst);
-		i->addSrc(src1);
-		break;
-	case T_LI:
-		eat(T_LI);
-		i = new Instruction(I_LI);
-
-		glance(T_R_ID);
-		dst = findVariable();
-		eat(T_R_ID);
-		eat(T_COMMA);
-
-		glance(T_NUM);
-		src1 = constVariable(stoi(currentToken->getValue()));
-		eat(T_NUM);
-
-		i->addDst(dst);
-		i->addSrc(src1);
-		break;
-	case T_LW:
-		eat(T_LW);
-		i = new Instruction(I_LW);
-
-		glance(T_R_ID);
-		dst = findVariable();
-		eat(T_R_ID);
-		eat(T_COMMA);
-
-		glance(T_NUM);
-		src1 = constVariable(stoi(currentToken->getValue()));
-		eat(T_NUM);
-		eat(T_L_PARENT);
-
-		glance(T_R_ID);
-		src2 = findVariable();
-		eat(T_R_ID);
-		eat(T_R_PARENT);
-
-		i->addDst(dst);
-		i->addSrc(src1);
-		i->addSrc(src2);
-		break;
-	case T_NOP:
-		eat(T_NOP);
-		i = new Instruction(I_NOP);
-
-		break;
-	case T_SUB:
-		eat(T_SUB);
-		i = new Instruction(I_SUB);
-
-		glance(T_R_ID);
-		dst = findVariable();
-		eat(T_R_ID);
-		eat(T_COMMA);
-
-		glance(T_R_ID);
-		src1 = findVariable();
-		eat(T_R_ID);
-		eat(T_COMMA);
-
-		glance(T_R_ID);
-		src2 = findVariable();
-		eat(T_R_ID);
-
-		i->addDst(dst);
-		i->addSrc(src1);
-		i->addSrc(src2);
-		break;
-	case T_SW:
-		eat(T_SW);
-		i = new Instruction(I_SW);
-
-		glance(T_R_ID);
-		src1 = findVariable();
-		eat(T_R_ID);
-		eat(T_COMMA);
-
-		glance(T_NUM);
-		src2 = constVariable(stoi(currentToken->getValue()));
-		eat(T_NUM);
-		eat(T_L_PARENT);
-
-		glance(T_R_ID);
-		dst = findVariable();
-		eat(T_R_ID);
-		eat(T_R_PARENT);
-		
-		i->addSrc(src1);
-		i->addSrc(src2);
-		i->addSrc(dst);
-		break;
-	case T_AND:
-		eat(T_AND);
-		i = new Instruction(I_AND);
-
-		glance(T_R_ID);
-		dst = findVariable();
-		eat(T_R_ID);
-		eat(T_COMMA);
-
-		glance(T_R_ID);
-		src1 = findVariable();
-		eat(T_R_ID);
-		eat(T_COMMA);
-
-		glance(T_R_ID);
-		src2 = findVariable();
-		eat(T_R_ID);
-
-		i->addDst(dst);
-		i->addSrc(src1);
-		i->addSrc(src2);
-		break;
-	case T_OR:
-		eat(T_OR);
-		i = new Instruction(I_OR);
-
-		glance(T_R_ID);
-		dst = findVariable();
-		eat(T_R_ID);
-		eat(T_COMMA);
-
-		glance(T_R_ID);
-		src1 = findVariable();
-		eat(T_R_ID);
-		eat(T_COMMA);
-
-		glance(T_R_ID);
-		src2 = findVariable();
-		eat(T_R_ID);
-
-		i->addDst(dst);
-		i->addSrc(src1);
-		i->addSrc(src2);
-		break;
-	case T_NOT:
-		eat(T_NOT);
-		i = new Instruction(I_NOT);
-
-		glance(T_R_ID);
-		dst = findVariable();
-		eat(T_R_ID);
-		eat(T_COMMA);
-
-		glance(T_R_ID);
-		src1 = findVariable();
-		eat(T_R_ID);
-
-		i->addDst(dst);
-		i->addSrc(src1);
-		break;
-	case T_BNE:
-		eat(T_BNE);
-		i = new Instruction(I_BNE);
-
-		glance(T_R_ID);
-		src1 = findVariable();
-		eat(T_R_ID);
-		eat(T_COMMA);
+		err = true;
+		errorStream() << "No valid token found!" << std::endl;
+		throw(WRONG_TOKEN);
+	}
+	eat(descriptor->token);
+	// the label is taken before the operands, a jump to a label defined later adds its placeholder to the labels
+	Instruction i(descriptor->type, next_instruction_has_label ? label_vars.back()->getId() : NO_VARIABLE);
 
-		glance(T_R_ID);
-		src2 = findVariable();
-		eat(T_R_ID);
-		eat(T_COMMA);
+	// operands are read in the order they are written in the format of the instruction
+	for (int step = 0; step < descriptor->numSteps; ++step)
+	{
+		TokenType token = descriptor->steps[step].token;
+		OperandKind kind = descriptor->steps[step].kind;
+		if (kind == O_NONE)
+		{
+			eat(token);
+			continue;
+		}
 
-		glance(T_ID);
-		dst = findLabel(currentToken->getValue());
-		eat(T_ID);
+		Variable* var;
+		glance(token);
+		switch (kind)
+		{
+		case O_CONST:
+			var = constVariable(currentNumber());
+			break;
+		case O_LABEL:
+			var = findLabel(currentSymbol());
+			break;
+		default:
+			var = findVariable();
+		}
+		eat(token);
 
-		i->addSrc(src1);
-		i->addSrc(src2);
-		i->addSrc(dst);
-		break;
-	default:
-		err = true;
-		std::cerr << "No valid token found!" << std::endl;
-		throw(WRONG_TOKEN);
+		i.addOperand(var->getId());
 	}
-	if (next_instruction_has_label)
-		i->addLabel(label_vars.back());
-	instrs.push_back(i);
+
+	addInstruction(i);
 }
 
 void printError(SyntaxAnalysis::SyntaxError e)
@@ -599,7 +946,10 @@ void printError(SyntaxAnalysis::SyntaxError e)
 	case SyntaxAnalysis::NO_MAIN_FUNC:
 		std::cout << "No starting function" << std::endl;
 		break;
-	case SyntaxAnalysis::TOO_MANY_FUNCS:
-		std::cout << "More than one function in code" << std::endl;
+	case SyntaxAnalysis::REGISTER_IN_MANY_FUNCS:
+		std::cout << "Register variable used in more than one function" << std::endl;
+		break;
+	case SyntaxAnalysis::LEXICAL_ERROR:
+		std::cout << "Lexical error found" << std::endl;
 	}
 }
@@ -7,6 +7,10 @@
 #define SYNTAX_ANALYSIS_H
 
 #include <list>
+#include <vector>
+#include <memory>
+#include <sstream>
+#include <unordered_map>
 
 #include "LexicalAnalysis.h"
 #include "IR.h"
@@ -27,26 +31,69 @@ public:
 		VARIABLE_DOESNT_EXIST,
 		LABEL_DOESNT_EXIST,
 		NO_MAIN_FUNC,
-		TOO_MANY_FUNCS
+		REGISTER_IN_MANY_FUNCS,
+		LEXICAL_ERROR
 	};
 
 	/**
 	* Constructor which prepares the object to do syntax analysis
-	* [in] lexer - results gotten form the lexical analysis
+	* [in] lexer      - results gotten form the lexical analysis, the variables and instructions
+	*                   are created in the compilation context of the lexer
+	* [in] pullTokens - if true tokens are read from the lexer while parsing instead of from the
+	*                   token list, so LexicalAnalysis::Do doesn't have to be called beforehand
 	*/
-	SyntaxAnalysis(LexicalAnalysis& lexer);
+	SyntaxAnalysis(LexicalAnalysis& lexer, bool pullTokens = false);
 
 	/**
-	* Destructor that ensures that all pointers are deleted when syntax
-	* analysis object goes out of scope
+	* Method which does syntax analysis
+	* [out] return - boolean value if the operation was done without a problem
 	*/
-	~SyntaxAnalysis();
+	bool Do();
 
 	/**
-	* Method which does syntax analysis
+	* Method which does syntax analysis of a module that is compiled on its own and linked with
+	* other modules: labels that aren't defined and memory variables that aren't declared are
+	* left to the link step (see getLabels and getExterns)
 	* [out] return - boolean value if the operation was done without a problem
 	*/
-	bool Do();
+	bool DoModule();
+
+	/**
+	* Method which does syntax analysis of a large program on multiple threads
+	*
+	* The program buffer of the lexer is split into parts after statements (at a ';' that is
+	* not in a comment), every part is lexed and parsed on its own thread and the results are
+	* merged in program order. Names that a part uses but doesn't declare are resolved during
+	* the merge and the reported error is the first one in the program, same as with Do().
+	* Every part has its own compilation context, which is kept alive by the context of this one.
+	* Tokens are pulled from the part lexers, so LexicalAnalysis::Do doesn't have to be called,
+	* a streamed input is read whole before it is split.
+	* Programs smaller than PARALLEL_PARSE_CHUNK_SIZE are analysed with Do().
+	*
+	* [out] return - boolean value if the operation was done without a problem
+	*/
+	bool DoParallel();
+
+	/**
+	* Method which does syntax analysis of a large module on multiple threads, the same as DoParallel
+	* with what is left to the link step the same as with DoModule
+	* [out] return - boolean value if the operation was done without a problem
+	*/
+	bool DoParallelModule();
+
+	/**
+	* Writes the analysed program into a binary IR image (see IRImage.h)
+	* [in] fileName - path of the image
+	*/
+	void writeImage(const std::string& fileName);
+	/**
+	* Loads a program from a binary IR image instead of analysing it, the image is memory mapped
+	* and its records are turned into variables and instructions without lexing anything
+	* (used on an object that hasn't analysed a program yet)
+	* [in]  fileName - path of the image
+	* [out] return   - false if the file can't be read or isn't a valid image of this version
+	*/
+	bool readImage(const std::string& fileName);
 
 	/**
 	* Print instructions gotten from syntax analysis
@@ -72,8 +119,68 @@ public:
 	* [out] return - list of instructions by reference
 	*/
 	Instructions& getInstructions();
+	/**
+	* Returns a reference to the list of labels, labels that aren't defined (module mode) have the value 0
+	* [out] return - list of variables by reference
+	*/
+	Variables& getLabels();
+	/**
+	* Returns the positions of the labeled instructions by the ids of their labels (-1 or past the end
+	* for labels that aren't defined), the index is filled while the instructions are read
+	* [out] return - vector of positions by reference
+	*/
+	std::vector<int>& getLabelPositions();
+	/**
+	* Returns a reference to the list of memory variables used but not declared (module mode)
+	* [out] return - list of variables by reference
+	*/
+	Variables& getExterns();
+	/**
+	* Returns the compilation the analysed program belongs to
+	* [out] return - compilation context by reference
+	*/
+	CompilationContext& getContext();
 
 private:
+	/**
+	* Returns the token the given number of tokens after the current one,
+	* in pull mode the lookahead ring is filled from the lexer as needed
+	* [in]  ahead  - distance from the current token (less than TOKEN_LOOKAHEAD)
+	* [out] return - reference to the token in the lookahead ring
+	*/
+	const Token& peek(size_t ahead = 0);
+	/**
+	* Returns the type of the current token
+	*/
+	TokenType currentType();
+	/**
+	* Returns the value of the current number token
+	*/
+	int currentNumber();
+	/**
+	* Returns the symbol of the current token
+	*/
+	unsigned currentSymbol();
+	/**
+	* Moves to the next token
+	*/
+	void advance();
+	/**
+	* Returns the stream syntax errors are written to (a buffer if the part
+	* of the program is parsed in partial mode, so that it can be reported later)
+	*/
+	std::ostream& errorStream();
+
+	/**
+	* Splits the source into parts of similar size, every part except the first one starts
+	* right after a ';' that is not in a comment
+	* [in]  source - first character of the source
+	* [in]  length - number of characters in the source
+	* [in]  parts  - wanted number of parts
+	* [out] return - offsets of the part beginnings followed by the length of the source
+	*/
+	static std::vector<size_t> splitSource(const char* source, size_t length, size_t parts);
+
 	/**
 	* Private method which moves the iterator to the next token
 	  (eats the upcoming one) and return if there has been an error
@@ -90,19 +197,50 @@ private:
 
 	/**
 	* Check if register variable with the given name already exists and raise error if it does
-	* [in] name - string to which to compare register variable names to
+	* [in] symbol - symbol of the name to which to compare register variable names to
 	*/
-	void regVariableExists(std::string& name);
+	void regVariableExists(unsigned symbol);
 	/**
 	* Check if memory variable with the given name already exists and raise error if it does
-	* [in] name - string to which to compare memory variable names to
+	* [in] symbol - symbol of the name to which to compare memory variable names to
 	*/
-	void memVariableExists(std::string& name);
+	void memVariableExists(unsigned symbol);
 	/**
 	* Check if label with the given name already exists and raise error if it does
-	* [in] name - string to which to compare names of existing labels
+	* [in] symbol - symbol of the name to which to compare names of existing labels
+	*/
+	void labelExists(unsigned symbol);
+
+	/**
+	* Returns the entry of the given symbol in an index of variables, the index is grown
+	* to the size of the symbol table if needed (entries of missing variables are nullptr)
+	* [in]  index  - index of variables by symbol
+	* [in]  symbol - symbol of the name of the variable
+	* [out] return - reference to the entry
+	*/
+	Variable*& indexedVariable(std::vector<Variable*>& index, unsigned symbol);
+	/**
+	* Returns the position of the label with the given symbol in the list of labels
+	* (label_vars.end() if there is no such label)
+	* [in]  symbol - symbol of the name of the label
+	* [out] return - reference to the position in the index
+	*/
+	Variables::iterator& indexedLabel(unsigned symbol);
+	/**
+	* Adds a label at the end of the list of labels
+	* [in] label - label to add
+	*/
+	void addLabel(Variable* label);
+	/**
+	* Adds an instruction at the end of the program
+	* [in] instruction - instruction to add
+	*/
+	void addInstruction(const Instruction& instruction);
+	/**
+	* Keeps the position of a labeled instruction in the index of positions of labels
+	* [in] position - position of the instruction in instrs
 	*/
-	void labelExists(std::string& name);
+	void indexLabelPosition(int position);
 
 	/**
 	* Method which looks at the next token and turns it into a correct type of variable
@@ -116,36 +254,36 @@ private:
 	Variable* findVariable();
 	/**
 	* Method that returns a pointer to a constant variable
+	*
+	* (creates a constant/immediate if it doesn't already exist, this is done so that all
+	* constants in the program are saved as variables, but also so that if the same number is
+	* used multiple times there is only one copy of it)
+	*
 	* [in]  value - intiger number that represent the passed in value
 	* [out] return - pointer to the wanted variable
 	*/
 	Variable* constVariable(int value);
 	/**
-	* Method that returns a pointer to the variable with the same name as the string given to it
-	*
-	* To create a constant variable pass in ("c" + value) as the argument
-	* (creates a constant/immediate if it doesn't already exist, this is done so that all
-	* constants in the program are saved as variables, but also so that if the same number is
-	* used multiple times there is only one copy of it)
-	* 
-	* [in]  name - string of the variable you are trying to find
+	* Method that returns a pointer to the variable with the name of the given symbol
+	* [in]  symbol - symbol of the name of the variable you are trying to find
 	* [out] return - pointer to the found variable
 	*/
-	Variable* findVariable(std::string& name);
+	Variable* findVariable(unsigned symbol);
 	/**
-	* Method that returns a pointer to the variable with the same name as the string given to it
-	* [in]  name - string of the variable you are trying to find
+	* Method that returns a pointer to the label with the name of the given symbol
+	* [in]  symbol - symbol of the name of the label you are trying to find
 	* [out] return - pointer to the found variable
 	*/
-	Variable* findLabel(std::string& name);
+	Variable* findLabel(unsigned symbol);
 	/**
 	* Method that is used to raise an error at the end if a jump/branching was called
-	* to a label that doesn't exist (is connected to nothing)
+	* to a label that doesn't exist (is connected to nothing), in module mode it is left to the link step
 	*/
 	void checkLabels();
 	/**
-	* Method for checking if there are multiple functions in the program and if the first instruction
-	* is a function from which the assembly program can start from
+	* Method for checking if the first instruction is a function from which the assembly program can
+	* start from and if every register variable is used in only one function (registers are allocated
+	* for every function on its own)
 	*/
 	void checkFunctions();
 
@@ -153,13 +291,18 @@ private:
 	/**
 	* Q -> comment L
 	* Q -> S ; L
+	*
+	* Statements are read in a loop, L -> Q continues it
 	*/
 	void Q();
 	/**
 	* L -> eof
 	* L -> Q
+	*
+	* Reads the end of the file if it is next, Q is left to the caller
+	* [out] return - true if the end of the file was read
 	*/
-	void L();
+	bool L();
 	/**
 	* S -> mem m_id num
 	* S -> reg r_id
@@ -183,19 +326,54 @@ private:
 	* E -> and  r_id , r_id , r_id
 	* E -> or   r_id , r_id , r_id
 	* E -> not  r_id , r_id
+	* E -> bne  r_id , r_id , id
+	*
+	* The productions are read from the formats in InstructionSet
 	*/
 	void E();
 
+	/**
+	* Use of an undeclared variable or a declaration found while parsing a part of the
+	* program in partial mode, checked against the earlier parts when they are merged
+	*/
+	struct DeferredCheck
+	{
+		bool declaration;             // True for declarations, false for uses of undeclared variables
+		Variable* var;                // Declared variable or the placeholder for the used one
+	};
+
 	LexicalAnalysis& lex;             // Refernece to lexical analysis results
-	TokenList::iterator currentToken; // Current token that is being analysed
-	Instructions instrs;              // List of instructions
+	CompilationContext& context;      // Compilation the variables and instructions belong to
+	TokenStream& tokens;              // Tokens gotten from lexical analysis
+	SymbolTable& symbols;             // Names of identifiers gotten from lexical analysis
+	size_t currentToken;              // Index of the current token that is being analysed
+	bool pull;                        // Boolean value that shows if tokens are pulled from the lexer
+	Token lookahead[TOKEN_LOOKAHEAD]; // Ring of tokens pulled from the lexer but not eaten yet
+	size_t lookaheadHead;             // Position of the current token in the lookahead ring
+	size_t lookaheadCount;            // Number of tokens in the lookahead ring
+	Pool<Variable>& variablePool;     // Variables of the compilation
+	Instructions instrs;              // Instructions of the program
 	Variables reg_vars;               // List of register variables 
 	Variables mem_vars;               // List of memory address variables
 	Variables label_vars;             // List of labels
 	Variables const_vars;             // List of variables that hold const values
+	std::vector<Variable*> reg_index; // Register variables by symbol of their name
+	std::vector<Variable*> mem_index; // Memory variables by symbol of their name
+	std::vector<Variables::iterator> label_index; // Positions of labels in label_vars by symbol of their name
+	std::vector<int> label_positions; // Positions of labeled instructions in instrs by the ids of their labels
+	std::unordered_map<int, Variable*> const_pool; // Constants by their value
 	bool err;                         // Boolean value which shows if there has been an error
 	bool eof;                         // Boolean value that represents if EOF token has been read
-	bool next_instruction_has_label;  // Boolean value which if true says that the next instruction should pick up a label
+	bool next_instruction_has_label;  // Boolean value which if true says that the next instruction should pick up the last defined label
+	bool partial;                     // Boolean value that shows if only a part of the program is being parsed
+	bool lexicalError;                // Boolean value that shows if a lexical error wasn't printed yet (partial mode)
+	std::ostringstream messages;      // Error messages not printed yet (partial mode)
+	Variables unresolved_vars;        // Placeholders for variables used but not declared (partial mode)
+	std::vector<Variable*> unresolved_index; // Placeholders by symbol of their name (partial mode)
+	std::vector<DeferredCheck> deferred; // Checks left for the merge (partial mode)
+	bool module;                      // Boolean value that shows if a module is parsed (undefined names are left to the link step)
+	Variables extern_vars;            // Memory variables used but not declared (module mode)
+	std::vector<Variable*> extern_index; // Memory variables used but not declared by symbol of their name (module mode)
 };
 
 /**
@@ -5,16 +5,19 @@
 
 #include <iostream>
 #include <iomanip>
+#include <climits>
+#include <algorithm>
 
 #include "Token.h"
 #include "FiniteStateMachine.h"
+#include "Keywords.h"
 
 using namespace std;
 
 
-TokenType Token::getType()
+TokenType Token::getType() const
 {
-	return tokenType;
+	return (TokenType)tokenType;
 }
 
 
@@ -24,34 +27,104 @@ void Token::setType(TokenType t)
 }
 
 
-string Token::getValue()
+string_view Token::getValue() const
 {
-	return value;
+	return string_view(value, length);
 }
 
 
-void Token::setValue(string s)
+void Token::setValue(string_view s)
 {
-	value = s;
+	value = s.data();
+	length = (unsigned int)min(s.size(), (size_t)MAX_TOKEN_LENGTH);
 }
 
 
-void Token::makeToken(int begin, int end, std::vector<char>& programBuffer,  int lastFiniteState)
+unsigned Token::getSymbol() const
 {
-	string _value = "";
-	for (int i = begin; i < end; i++)
+	bool identifier = tokenType == T_ID || tokenType == T_M_ID || tokenType == T_R_ID;
+	return identifier ? attribute : NO_SYMBOL;
+}
+
+
+void Token::setSymbol(unsigned s)
+{
+	attribute = s;
+}
+
+
+int Token::getNumber() const
+{
+	return (int)attribute;
+}
+
+
+void Token::setNumber(int n)
+{
+	attribute = (unsigned)n;
+}
+
+
+LexicalError Token::getError() const
+{
+	return tokenType == T_ERROR ? (LexicalError)attribute : LE_NONE;
+}
+
+
+void Token::setError(LexicalError e)
+{
+	attribute = e;
+}
+
+
+void Token::makeToken(size_t begin, size_t end, const char* programBuffer, int lastFiniteState)
+{
+	value = programBuffer + begin;
+	length = (unsigned int)min(end - begin, (size_t)MAX_TOKEN_LENGTH);
+	attribute = NO_SYMBOL;
+	tokenType = FiniteStateMachine::getTokenType(lastFiniteState);
+	if (end - begin > MAX_TOKEN_LENGTH && lastFiniteState != COMMENT_STATE)
 	{
-		_value += programBuffer[i];
+		tokenType = T_ERROR;
+		attribute = LE_TOKEN_TOO_LONG;
+	}
+	else if (lastFiniteState == IDENTIFIER_STATE || lastFiniteState == RESERVED_WORD_STATE)
+	{
+		// an underscore word that isn't reserved stays an error token
+		tokenType = Keywords::find(getValue(), (TokenType)tokenType);
+		if (tokenType == T_ERROR)
+			attribute = LE_MALFORMED_TOKEN;
+	}
+	else if (tokenType == T_ERROR)
+	{
+		attribute = LE_MALFORMED_TOKEN;
+	}
+	else if (lastFiniteState == NUMBER_STATE)
+	{
+		// the lexeme is made only of digits, so its value is accumulated without checks
+		// other than the overflow
+		int number = 0;
+		for (unsigned int i = 0; i < length; i++)
+		{
+			int digit = value[i] - '0';
+			if (number > (INT_MAX - digit) / 10)
+			{
+				tokenType = T_ERROR;
+				break;
+			}
+			number = number * 10 + digit;
+		}
+		attribute = tokenType == T_ERROR ? (unsigned)LE_NUMBER_OUT_OF_RANGE : (unsigned)number;
 	}
-	value = _value;
-	tokenType = FiniteStateMachine::getTokenType(lastFiniteState);
 }
 
 
-void Token::makeErrorToken(int pos, std::vector<char>& programBuffer)
+void Token::makeErrorToken(size_t pos, const char* programBuffer, LexicalError error)
 {
 	tokenType = T_ERROR;
-	value = programBuffer[pos];
+	value = programBuffer + pos;
+	length = 1;
+	attribute = error;
 }
 
 
@@ -59,19 +132,20 @@ void Token::makeEofToken()
 {
 	tokenType = T_END_OF_FILE;
 	value = "EOF";
+	length = 3;
 }
 
 
 void Token::printTokenInfo()
 {
-	cout << setw(LEFT_ALIGN) << left << tokenTypeToString(tokenType);
-	cout << setw(RIGHT_ALIGN) << right << value << endl;
+	cout << setw(LEFT_ALIGN) << left << tokenTypeToString((TokenType)tokenType);
+	cout << setw(RIGHT_ALIGN) << right << getValue() << endl;
 }
 
 
 void Token::printTokenValue()
 {
-	cout << value << endl;
+	cout << getValue() << endl;
 }
 
 
@@ -151,3 +225,15 @@ string tokenTypeToString(TokenType t)
 	default:				return "";
 	}
 }
+
+string lexicalErrorToString(LexicalError e)
+{
+	switch (e)
+	{
+	case LE_UNSUPPORTED_CHARACTER:	return "Unsupported character";
+	case LE_NUMBER_OUT_OF_RANGE:	return "Number out of range";
+	case LE_TOKEN_TOO_LONG:			return "Token too long";
+	case LE_MALFORMED_TOKEN:		return "Malformed token";
+	default:						return "Lexical error";
+	}
+}
@@ -1,8 +1,8 @@
 #ifndef __TOKEN__
 #define __TOKEN__
 
-#include <vector>
 #include <string>
+#include <string_view>
 
 #include "Constants.h"
 #include "Types.h"
@@ -11,12 +11,12 @@
 class Token
 {
 public:
-	Token() : tokenType(T_NO_TYPE), value("") {}
+	Token() : value(""), length(0), tokenType(T_NO_TYPE), attribute(NO_SYMBOL) {}
 
 	/**
 	 * Returns token type
 	 */
-	TokenType getType();
+	TokenType getType() const;
 
 	/**
 	 * Sets token type
@@ -24,29 +24,62 @@ public:
 	void setType(TokenType t);
 
 	/**
-	 * Returns token value
+	 * Returns token value, a view into the program buffer
+	 * (valid as long as the source the token was read from)
 	 */
-	std::string getValue();
+	std::string_view getValue() const;
 
 	/**
-	 * Sets token value
+	 * Sets token value, the characters are not copied and must outlive the token
 	 */
-	void setValue(std::string s);
+	void setValue(std::string_view s);
 
 	/**
-	 * Creates a token
+	 * Returns the symbol of an identifier token (NO_SYMBOL for other tokens)
+	 */
+	unsigned getSymbol() const;
+
+	/**
+	 * Sets the symbol of an identifier token
+	 */
+	void setSymbol(unsigned s);
+
+	/**
+	 * Returns the value of a number token
+	 */
+	int getNumber() const;
+
+	/**
+	 * Sets the value of a number token
+	 */
+	void setNumber(int n);
+
+	/**
+	 * Returns what went wrong while reading an error token (LE_NONE for other tokens)
+	 */
+	LexicalError getError() const;
+
+	/**
+	 * Sets what went wrong while reading an error token
+	 */
+	void setError(LexicalError e);
+
+	/**
+	 * Creates a token, the value of a number is computed here
+	 * (a number that doesn't fit in an int and a lexeme that isn't a token become error tokens)
 	 * [in] begin - start position in the program buffer - first character of the token
 	 * [in] end - end position in the program buffer - end character of the token
 	 * [in] program - program buffer
 	 * [in] lastFiniteState - number of the last finite state,
 	 *		this is used to get the name of the state and store it as token type
 	 */
-	void makeToken(int begin, int end, std::vector<char>& program, int lastFiniteState);
+	void makeToken(size_t begin, size_t end, const char* program, int lastFiniteState);
 
 	/**
 	 * Creates an error token, storing the errnous content as token value
+	 * [in] error - what went wrong, an unsupported character or one that can't start a token
 	 */
-	void makeErrorToken(int pos, std::vector<char>& program);
+	void makeErrorToken(size_t pos, const char* program, LexicalError error);
 
 	/**
 	 * Creates end of file token when it is reached
@@ -64,15 +97,27 @@ public:
 	void printTokenValue();
 
 private:
+	/**
+	 * First character of the token value in the program buffer
+	 */
+	const char* value;
+
+	/**
+	 * Number of characters in the token value (at most MAX_TOKEN_LENGTH)
+	 */
+	unsigned int length : 24;
+
 	/**
 	 * Type of the token - as enumeration (defined in common.h)
 	 */
-	TokenType tokenType;
-	
+	unsigned int tokenType : 8;
+
 	/**
-	 * Value of the token - as string
+	 * Symbol of the identifier name in the symbol table of the lexical analysis,
+	 * value of the number token or lexical error of the error token - a token never has
+	 * more than one, as in TokenStream
 	 */
-	std::string value;
+	unsigned attribute;
 	
 	/**
 	 * Helper function to get string representation of token type
@@ -80,9 +125,16 @@ private:
 	std::string tokenTypeToString(TokenType t);
 };
 
+static_assert(sizeof(Token) <= 16, "Token should stay a small value type");
+
 /**
 * Helper function to get string representation of token type
 */
 std::string tokenTypeToString(TokenType t);
 
+/**
+* Helper function to get the description of a lexical error
+*/
+std::string lexicalErrorToString(LexicalError e);
+
 #endif
@@ -0,0 +1,68 @@
+#include "TokenStream.h"
+
+using namespace std;
+
+
+void TokenStream::reserve(const char* programBuffer, size_t sourceSize)
+{
+	program = programBuffer;
+	programSize = sourceSize;
+}
+
+
+void TokenStream::reserveTokens(size_t numTokens)
+{
+	types.reserve(numTokens);
+	offsets.reserve(numTokens);
+	lengths.reserve(numTokens);
+	attributes.reserve(numTokens);
+}
+
+
+void TokenStream::push_back(const Token& token)
+{
+	string_view value = token.getValue();
+	bool inProgram = token.getType() != T_END_OF_FILE;
+
+	types.push_back((unsigned char)token.getType());
+	offsets.push_back(inProgram ? (size_t)(value.data() - program) : 0);
+	lengths.push_back(inProgram ? (unsigned int)value.size() : 0);
+	if (token.getType() == T_NUM)
+		attributes.push_back((unsigned)token.getNumber());
+	else if (token.getType() == T_ERROR)
+		attributes.push_back(token.getError());
+	else
+		attributes.push_back(token.getSymbol());
+
+	// the average number of bytes per emitted token, skipped whitespace and comments included,
+	// varies a lot between sources, so it is measured over the first tokens and the rest of the
+	// buffer is estimated from it, with an eighth more for denser parts (the arrays grow as usual
+	// if that isn't enough)
+	if (types.size() == TOKEN_SAMPLE_SIZE && inProgram)
+	{
+		size_t sampled = offsets.back() + lengths.back();
+		size_t expectedTokens = (size_t)((double)programSize / sampled * TOKEN_SAMPLE_SIZE);
+		reserveTokens(expectedTokens + expectedTokens / 8 + 1);
+	}
+}
+
+
+Token TokenStream::at(size_t index) const
+{
+	Token token;
+	if (types[index] == T_END_OF_FILE)
+	{
+		token.makeEofToken();
+	}
+	else
+	{
+		token.setType((TokenType)types[index]);
+		token.setValue(getValue(index));
+		token.setSymbol(getSymbol(index));
+		if (types[index] == T_NUM)
+			token.setNumber(getNumber(index));
+		else if (types[index] == T_ERROR)
+			token.setError((LexicalError)attributes[index]);
+	}
+	return token;
+}
@@ -0,0 +1,106 @@
+#ifndef __TOKEN_STREAM__
+#define __TOKEN_STREAM__
+
+#include <vector>
+#include <string_view>
+
+#include "Token.h"
+
+/**
+ * Sequence of tokens stored as parallel arrays (type, value offset, value length and attribute),
+ * so that walking over the tokens is a sequential scan of contiguous arrays.
+ * The attribute is the symbol of an identifier, the value of a number or the lexical error
+ * of an error token.
+ * Token values are offsets into the program buffer the tokens were read from.
+ */
+class TokenStream
+{
+public:
+	TokenStream() : program(nullptr), programSize(0) {}
+
+	/**
+	 * Sets the program buffer that token values point into, room for the tokens of the whole
+	 * buffer is reserved once the first TOKEN_SAMPLE_SIZE tokens show how long a token is
+	 * [in] programBuffer - first character of the program buffer
+	 * [in] sourceSize    - size of the program buffer
+	 */
+	void reserve(const char* programBuffer, size_t sourceSize);
+
+	/**
+	 * Appends a token, its value must point into the program buffer (except for EOF)
+	 */
+	void push_back(const Token& token);
+
+	/**
+	 * Returns the number of tokens
+	 */
+	size_t size() const
+	{
+		return types.size();
+	}
+
+	/**
+	 * Returns true if there are no tokens
+	 */
+	bool empty() const
+	{
+		return types.empty();
+	}
+
+	/**
+	 * Returns the type of the token at the given index
+	 */
+	TokenType getType(size_t index) const
+	{
+		return (TokenType)types[index];
+	}
+
+	/**
+	 * Returns the symbol of the token at the given index (NO_SYMBOL if it isn't an identifier)
+	 */
+	unsigned getSymbol(size_t index) const
+	{
+		bool identifier = types[index] == T_ID || types[index] == T_M_ID || types[index] == T_R_ID;
+		return identifier ? attributes[index] : NO_SYMBOL;
+	}
+
+	/**
+	 * Returns the value of the number token at the given index
+	 */
+	int getNumber(size_t index) const
+	{
+		return (int)attributes[index];
+	}
+
+	/**
+	 * Returns the value of the token at the given index
+	 */
+	std::string_view getValue(size_t index) const
+	{
+		if (types[index] == T_END_OF_FILE)
+			return "EOF";
+		return std::string_view(program + offsets[index], lengths[index]);
+	}
+
+	/**
+	 * Rebuilds the token at the given index
+	 */
+	Token at(size_t index) const;
+
+private:
+	/**
+	 * Reserves room for the given number of tokens in every array
+	 */
+	void reserveTokens(size_t numTokens);
+
+	const char* program;                 // Program buffer the token values point into
+	size_t programSize;                  // Size of the program buffer
+	std::vector<unsigned char> types;    // Token types
+	std::vector<size_t> offsets;         // Token value offsets in the program buffer
+	std::vector<unsigned int> lengths;   // Token value lengths
+	std::vector<unsigned> attributes;    // Symbols of identifiers, values of numbers and lexical errors
+};
+
+static_assert(T_ERROR <= 255, "Token types are stored as bytes");
+
+#endif
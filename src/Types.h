@@ -61,6 +61,19 @@ enum TokenType
 };
 
 
+/**
+ * What went wrong while reading an error token.
+ */
+enum LexicalError
+{
+	LE_NONE,
+	LE_UNSUPPORTED_CHARACTER,	// byte that isn't a supported character
+	LE_NUMBER_OUT_OF_RANGE,		// number that doesn't fit in an int
+	LE_TOKEN_TOO_LONG,			// lexeme longer than MAX_TOKEN_LENGTH
+	LE_MALFORMED_TOKEN,			// supported characters that don't form a token
+};
+
+
 /**
  * Instruction type.
  */
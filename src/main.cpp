@@ -5,12 +5,18 @@
 
 #include <iostream>
 #include <exception>
+#include <filesystem>
+#include <algorithm>
 
 #include "LivenessAnalysis.h"
+#include "Linker.h"
 
 using namespace std;
 
-int main()
+/**
+ * Compiles the example program and prints the results of all the phases (used when there are no arguments)
+ */
+static int demo()
 {
 	try
 	{
@@ -23,7 +29,8 @@ int main()
 		string outputFile = ".\\..\\examples\\out.s";
 		bool retVal = false;
 
-		LexicalAnalysis lex;
+		CompilationContext context;
+		LexicalAnalysis lex(context);
 
 		if (!lex.readInputFile(fileNames[0]))
 			throw runtime_error("\nException! Failed to open input file!\n");
@@ -83,3 +90,172 @@ int main()
 
 	return 0;
 }
+
+/**
+ * Compiles a MAVN file or an IR image into a module, the results of the phases aren't printed
+ * [in]  input      - path of the MAVN file or of the IR image (.mir)
+ * [in]  moduleFile - path of the module
+ * [in]  imageFile  - path of the IR image written after syntax analysis of a MAVN file (none if empty)
+ * [in]  cache      - results of the functions compiled so far
+ * [out] return     - false if the compilation failed (the error is printed)
+ */
+static bool compileModule(const string& input, const string& moduleFile, const string& imageFile, AllocationCache& cache)
+{
+	try
+	{
+		CompilationContext context;
+		LexicalAnalysis lex(context);
+		// tokens are pulled from the lexer while parsing, so they aren't all kept in memory
+		SyntaxAnalysis syn(lex, true);
+
+		if (filesystem::path(input).extension() == ".mir")
+		{
+			// the image already holds the parsed program
+			if (!syn.readImage(input))
+				throw runtime_error("\nException! Failed to read IR image " + input + "!\n");
+		}
+		else
+		{
+			if (!lex.readInputFile(input))
+				throw runtime_error("\nException! Failed to open input file " + input + "!\n");
+
+			lex.initialize();
+
+			// a mapped file is split into parts parsed on their own threads if it is large enough,
+			// a streamed one would have to be read whole first
+			bool parsed = lex.getProgramBuffer().isStream() ? syn.DoModule() : syn.DoParallelModule();
+			if (!parsed)
+				throw runtime_error("\nException! Syntax analysis of " + input + " failed!\n");
+
+			if (!imageFile.empty())
+				syn.writeImage(imageFile);
+		}
+
+		LivenessAnalysis la(syn, __NO_DUMPS__, &cache);
+		if (!la.Do())
+			throw runtime_error("\nException! Liveness analysis and resource alocation of " + input + " failed!\n");
+
+		la.getModule().write(moduleFile);
+	}
+	catch (runtime_error e)
+	{
+		cout << e.what() << endl;
+		return false;
+	}
+	catch (SyntaxAnalysis::SyntaxError e)
+	{
+		printError(e);
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Checks if the module of a MAVN file (or of an IR image) was written after the file was last changed
+ * [in]  input      - path of the MAVN file or of the IR image
+ * [in]  moduleFile - path of the module
+ * [out] return     - boolean value if the module doesn't have to be compiled again
+ */
+static bool isUpToDate(const string& input, const string& moduleFile)
+{
+	error_code error;
+	filesystem::file_time_type source = filesystem::last_write_time(input, error);
+	if (error)
+		return false;
+	filesystem::file_time_type compiled = filesystem::last_write_time(moduleFile, error);
+	return !error && compiled >= source;
+}
+
+/**
+ * mavn [-c] [-i] [-o output] [-m module] files...
+ *
+ * Every .mavn file is compiled into a module (.mo next to it) unless its module is newer than
+ * the file, .mo files are used as they are. With -i the parsed program of every compiled .mavn file
+ * is also saved as an IR image (.mir next to it), images are compiled into modules like .mavn files
+ * but without lexical and syntax analysis. A - reads a MAVN program from the standard input, it is
+ * streamed through the compiler and always compiled into the module given with -m (stdin.mo by default).
+ * The modules are linked into one program in the order they are given (out.s by default), with -c
+ * they are only compiled.
+ * Without arguments the example program is compiled with all the results printed.
+ */
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+		return demo();
+
+	vector<string> inputs;
+	string outputFile = "out.s";
+	string stdinModule = "stdin.mo";
+	bool link = true;
+	bool images = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		string arg = argv[i];
+		if (arg == "-c")
+			link = false;
+		else if (arg == "-i")
+			images = true;
+		else if (arg == "-o" && i + 1 < argc)
+			outputFile = argv[++i];
+		else if (arg == "-m" && i + 1 < argc)
+			stdinModule = argv[++i];
+		else if (arg[0] == '-' && (arg != "-" || find(inputs.begin(), inputs.end(), arg) != inputs.end()))
+		{
+			// the standard input can be read only once
+			cout << "Usage: " << argv[0] << " [-c] [-i] [-o output] [-m module] files..." << endl;
+			return 1;
+		}
+		else
+			inputs.push_back(arg);
+	}
+
+	// every file is compiled even if an earlier one fails, so that all the errors are reported,
+	// functions that are the same in several files are analysed once
+	Linker linker;
+	AllocationCache cache;
+	bool retVal = true;
+	for (const string& input : inputs)
+	{
+		bool isStdin = input == "-";
+		filesystem::path path(isStdin ? stdinModule : input);
+		bool isModule = !isStdin && path.extension() == ".mo";
+		string imageFile = images && path.extension() != ".mir" ? filesystem::path(path).replace_extension(".mir").string() : "";
+		string moduleFile = isModule || isStdin ? path.string() : path.replace_extension(".mo").string();
+
+		// with -i the image is written even if the module is up to date
+		if (!isModule && (isStdin || !isUpToDate(input, moduleFile) || (!imageFile.empty() && !isUpToDate(input, imageFile))) &&
+			!compileModule(input, moduleFile, imageFile, cache))
+		{
+			retVal = false;
+			continue;
+		}
+
+		// a module written by another version of the compiler is compiled again (the standard input can't be read again)
+		Module module;
+		if (!module.read(moduleFile) && (isModule || isStdin || !compileModule(input, moduleFile, imageFile, cache) || !module.read(moduleFile)))
+		{
+			cout << "\nException! Failed to read module " << moduleFile << "!\n" << endl;
+			retVal = false;
+			continue;
+		}
+		if (link)
+			linker.addModule(moduleFile, move(module));
+	}
+	if (!retVal || !link)
+		return retVal ? 0 : 1;
+
+	try
+	{
+		if (!linker.Do())
+			throw runtime_error("\nException! Linking failed!\n");
+		linker.writeToFile(outputFile);
+	}
+	catch (runtime_error e)
+	{
+		cout << e.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,92 @@
+/**
+ * Tests of the lexical analysis (src/LexicalAnalysis.cpp).
+ *
+ * Reads small sources from memory and checks the last token the lexer gives, the first error
+ * token or the end of file, and the lexical error it carries.
+ *
+ * Build and run from the tools directory:
+ *		g++ -std=c++17 LexerTests.cpp ../src/LexicalAnalysis.cpp ../src/Token.cpp ../src/TokenStream.cpp
+ *			../src/FiniteStateMachine.cpp ../src/DirectScanner.cpp ../src/CharacterClassifier.cpp ../src/Keywords.cpp
+ *			../src/SourceBuffer.cpp ../src/SymbolTable.cpp ../src/CompilationContext.cpp ../src/Arena.cpp -o LexerTests
+ *		./LexerTests
+ * or with MSVC (the same sources, backslashes instead of slashes):
+ *		cl /std:c++17 /EHsc LexerTests.cpp ..\src\LexicalAnalysis.cpp ...
+ *		LexerTests.exe
+ * The LexicalAnalysis project runs the tests as its pre-build event.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../src/LexicalAnalysis.h"
+
+using namespace std;
+
+
+/**
+ * One source and the token the lexer has to stop at
+ */
+struct LexerTest
+{
+	string name;          // Name printed when the test fails
+	string source;        // Source that is read
+	TokenType type;       // Type of the last token, T_ERROR or T_END_OF_FILE
+	LexicalError error;   // Lexical error of the last token
+};
+
+
+/**
+ * Reads the source until the first error token or the end of file
+ * [in]  source - source that is read
+ * [out] return - the error token or the end of file token
+ */
+Token lastToken(const string& source)
+{
+	CompilationContext context;
+	LexicalAnalysis lex(context);
+	lex.readInputBuffer(source.data(), source.size());
+	lex.initialize();
+
+	Token token = lex.getNextToken();
+	while (token.getType() != T_ERROR && token.getType() != T_END_OF_FILE)
+	{
+		token = lex.getNextToken();
+	}
+	return token;
+}
+
+
+int main()
+{
+	string header = "_reg r1;\n_func main;\n";
+	vector<LexerTest> tests = {
+		{ "valid program", header + "\tli r1, 3;\n", T_END_OF_FILE, LE_NONE },
+		{ "largest number", header + "\tli r1, 2147483647;\n", T_END_OF_FILE, LE_NONE },
+		{ "comment longer than MAX_TOKEN_LENGTH", "//" + string(MAX_TOKEN_LENGTH, 'c') + "\n" + header, T_END_OF_FILE, LE_NONE },
+		{ "unsupported character", header + "\tli r1, 3 # 4;\n", T_ERROR, LE_UNSUPPORTED_CHARACTER },
+		{ "number out of range", header + "\tli r1, 2147483648;\n", T_ERROR, LE_NUMBER_OUT_OF_RANGE },
+		{ "identifier longer than MAX_TOKEN_LENGTH", header + string(MAX_TOKEN_LENGTH + 1, 'x') + ":\n", T_ERROR, LE_TOKEN_TOO_LONG },
+		{ "number followed by a letter", header + "\tli r1, 5a;\n", T_ERROR, LE_MALFORMED_TOKEN },
+		{ "underscore word that isn't reserved", header + "_foo r1;\n", T_ERROR, LE_MALFORMED_TOKEN },
+		{ "start of a reserved word at the end of input", header + "_fu", T_ERROR, LE_MALFORMED_TOKEN },
+		{ "reserved word at the end of input", header + "_func", T_END_OF_FILE, LE_NONE },
+		{ "slash that doesn't start a comment", header + "\tli r1, 3 / 4;\n", T_ERROR, LE_MALFORMED_TOKEN },
+	};
+
+	int failed = 0;
+	for (const LexerTest& test : tests)
+	{
+		Token token = lastToken(test.source);
+		if (token.getType() != test.type || token.getError() != test.error)
+		{
+			cout << "FAILED: " << test.name << ", got " << tokenTypeToString(token.getType())
+				<< " (" << lexicalErrorToString(token.getError()) << "), expected " << tokenTypeToString(test.type)
+				<< " (" << lexicalErrorToString(test.error) << ")" << endl;
+			failed++;
+		}
+	}
+
+	cout << tests.size() - failed << " of " << tests.size() << " lexer tests passed" << endl;
+	return failed == 0 ? 0 : 1;
+}
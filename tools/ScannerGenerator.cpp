@@ -0,0 +1,334 @@
+/**
+ * Generator of the direct-coded lexical scanner (src/DirectScanner.cpp).
+ *
+ * Walks the transition table of FiniteStateMachine and writes out one labelled block per
+ * reachable state, with a switch on the next character that jumps directly to the next state.
+ *
+ * Build and run from the tools directory:
+ *		g++ -std=c++17 ScannerGenerator.cpp ../src/FiniteStateMachine.cpp ../src/DirectScanner.cpp -o ScannerGenerator
+ *		./ScannerGenerator ../src/DirectScanner.cpp
+ * or with MSVC:
+ *		cl /std:c++17 /EHsc ScannerGenerator.cpp ..\src\FiniteStateMachine.cpp ..\src\DirectScanner.cpp
+ *		ScannerGenerator.exe ..\src\DirectScanner.cpp
+ *
+ * With --check the scanner is not written, instead the tool fails if the given file differs from
+ * what it would generate, and then runs both scanners over the given sources (files or directories
+ * of .mavn files) and fails on the first position where they disagree:
+ *		ScannerGenerator.exe --check ..\src\DirectScanner.cpp ..\examples
+ * The LexicalAnalysis project runs this check as its pre-build event.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <queue>
+#include <stdexcept>
+#include <filesystem>
+
+#include "../src/FiniteStateMachine.h"
+#include "../src/DirectScanner.h"
+
+using namespace std;
+
+
+/**
+ * Returns a C++ character literal for the given byte
+ */
+string characterLiteral(int byte)
+{
+	switch (byte)
+	{
+		case '\t':	return "'\\t'";
+		case '\n':	return "'\\n'";
+		case '\r':	return "'\\r'";
+		case '\'':	return "'\\''";
+		case '\\':	return "'\\\\'";
+	}
+
+	stringstream ss;
+	if (byte >= 32 && byte < 127)
+		ss << '\'' << (char)byte << '\'';
+	else
+		ss << byte;
+	return ss.str();
+}
+
+
+/**
+ * Returns the label name of the given state
+ */
+string stateLabel(int state)
+{
+	stringstream ss;
+	ss << "state" << setw(2) << setfill('0') << state;
+	return ss.str();
+}
+
+
+/**
+ * Collects the transitions of one state, grouped by the next state
+ *		map<NextStateNumber, vector<TransitionByte>>
+ */
+map<int, vector<int>> collectTransitions(int state)
+{
+	map<int, vector<int>> transitions;
+	for (int byte = 0; byte < NUM_OF_BYTES; byte++)
+	{
+		int nextState = FiniteStateMachine::getNextState(state, (char)byte);
+		if (nextState == START_STATE)
+			throw runtime_error("Transition into START_STATE found, the FSM would never stop!");
+		if (nextState > IDLE_STATE)
+			transitions[nextState].push_back(byte);
+	}
+	return transitions;
+}
+
+
+/**
+ * Returns states reachable from START_STATE in breadth first order
+ */
+vector<int> reachableStates()
+{
+	vector<bool> visited(NUM_STATES, false);
+	vector<int> states;
+	queue<int> toVisit;
+
+	toVisit.push(START_STATE);
+	visited[START_STATE] = true;
+	while (!toVisit.empty())
+	{
+		int state = toVisit.front();
+		toVisit.pop();
+		states.push_back(state);
+
+		map<int, vector<int>> transitions = collectTransitions(state);
+		for (map<int, vector<int>>::iterator it = transitions.begin(); it != transitions.end(); it++)
+		{
+			if (!visited[it->first])
+			{
+				visited[it->first] = true;
+				toVisit.push(it->first);
+			}
+		}
+	}
+	return states;
+}
+
+
+void writeState(ostream& out, int state)
+{
+	map<int, vector<int>> transitions = collectTransitions(state);
+
+	if (state != START_STATE)
+	{
+		out << stateLabel(state) << ":\n";
+		out << "\tlastFiniteState = " << state << ";\n";
+		out << "\tmarker = cursor;\n";
+	}
+
+	if (transitions.empty())
+	{
+		out << "\treturn marker;\n\n";
+		return;
+	}
+
+	out << "\tif (cursor == limit)\n";
+	out << "\t\treturn marker;\n";
+	out << "\tswitch ((unsigned char)*cursor++)\n";
+	out << "\t{\n";
+	for (map<int, vector<int>>::iterator it = transitions.begin(); it != transitions.end(); it++)
+	{
+		vector<int>& bytes = it->second;
+		for (size_t i = 0; i < bytes.size(); i++)
+		{
+			out << (i % 8 == 0 ? "\t\t" : " ") << "case " << characterLiteral(bytes[i]) << ":";
+			if (i % 8 == 7 || i + 1 == bytes.size())
+				out << "\n";
+		}
+		out << "\t\t\tgoto " << stateLabel(it->first) << ";\n";
+	}
+	out << "\t\tdefault:\n";
+	out << "\t\t\treturn marker;\n";
+	out << "\t}\n\n";
+}
+
+
+void writeScanner(ostream& out)
+{
+	out << "/**\n";
+	out << " * GENERATED by tools/ScannerGenerator.cpp from FiniteStateMachine, do not edit by hand.\n";
+	out << " */\n\n";
+	out << "#include \"DirectScanner.h\"\n\n\n";
+	out << "const char* DirectScanner::scan(const char* cursor, const char* limit, int& lastFiniteState)\n";
+	out << "{\n";
+	out << "\tconst char* marker = cursor;\n";
+	out << "\tlastFiniteState = IDLE_STATE;\n\n";
+
+	vector<int> states = reachableStates();
+	for (size_t i = 0; i < states.size(); i++)
+	{
+		writeState(out, states[i]);
+	}
+
+	out << "}\n";
+}
+
+
+/**
+ * Returns the generated scanner with CRLF line endings, as the rest of the sources
+ */
+string generateScanner()
+{
+	stringstream ss;
+	writeScanner(ss);
+
+	string text;
+	for (char c : ss.str())
+	{
+		if (c == '\n')
+			text += '\r';
+		text += c;
+	}
+	return text;
+}
+
+
+/**
+ * Returns the whole content of the file
+ */
+string readFile(const string& path)
+{
+	ifstream inputFile(path, ios_base::binary);
+	if (!inputFile)
+		throw runtime_error("\nException! Failed to open input file " + path + "!\n");
+
+	stringstream ss;
+	ss << inputFile.rdbuf();
+	return ss.str();
+}
+
+
+/**
+ * Returns the text without carriage returns, git may check the sources out with either line ending
+ */
+string withoutCarriageReturns(const string& text)
+{
+	string result;
+	for (char c : text)
+	{
+		if (c != '\r')
+			result += c;
+	}
+	return result;
+}
+
+
+/**
+ * Runs FiniteStateMachine::scan and DirectScanner::scan from every position of the source,
+ * not only from token starts, so that more of the transitions are taken
+ * [in] path - path of the source, used in the message
+ * [in] source - content of the source
+ * return - true if both scanners stop at the same character in the same state everywhere
+ */
+bool compareScanners(const string& path, const string& source)
+{
+	const char* begin = source.data();
+	const char* limit = begin + source.size();
+	for (const char* cursor = begin; cursor != limit; cursor++)
+	{
+		int tableState;
+		int directState;
+		const char* tableEnd = FiniteStateMachine::scan(cursor, limit, tableState);
+		const char* directEnd = DirectScanner::scan(cursor, limit, directState);
+		if (tableEnd != directEnd || tableState != directState)
+		{
+			cout << path << ": scanners differ at offset " << (cursor - begin)
+				<< ", FiniteStateMachine stops at " << (tableEnd - begin) << " in state " << tableState
+				<< ", DirectScanner at " << (directEnd - begin) << " in state " << directState << endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/**
+ * Checks that the scanner is up to date and that both scanners agree over the sources
+ * [in] scannerPath - path of the generated scanner
+ * [in] sourcePaths - files or directories of .mavn files
+ * return - true if the check passed
+ */
+bool checkScanner(const string& scannerPath, const vector<string>& sourcePaths)
+{
+	if (withoutCarriageReturns(readFile(scannerPath)) != withoutCarriageReturns(generateScanner()))
+	{
+		cout << scannerPath << " is out of date, regenerate it with tools/ScannerGenerator.cpp" << endl;
+		return false;
+	}
+
+	int sources = 0;
+	for (const string& sourcePath : sourcePaths)
+	{
+		vector<string> files;
+		if (filesystem::is_directory(sourcePath))
+		{
+			for (const filesystem::directory_entry& entry : filesystem::directory_iterator(sourcePath))
+			{
+				if (entry.path().extension() == ".mavn")
+					files.push_back(entry.path().string());
+			}
+		}
+		else
+		{
+			files.push_back(sourcePath);
+		}
+
+		for (const string& file : files)
+		{
+			if (!compareScanners(file, readFile(file)))
+				return false;
+			sources++;
+		}
+	}
+
+	cout << scannerPath << " is up to date, the scanners agree over " << sources << " sources" << endl;
+	return true;
+}
+
+
+int main(int argc, char* argv[])
+{
+	try
+	{
+		if (argc < 2)
+		{
+			cout << generateScanner();
+			return 0;
+		}
+
+		if (string(argv[1]) == "--check")
+		{
+			if (argc < 3)
+				throw runtime_error("\nUsage: ScannerGenerator --check scanner [source...]\n");
+
+			return checkScanner(argv[2], vector<string>(argv + 3, argv + argc)) ? 0 : 1;
+		}
+
+		ofstream outputFile(argv[1], ios_base::binary);
+		if (!outputFile)
+			throw runtime_error("\nException! Failed to open output file!\n");
+
+		outputFile << generateScanner();
+	}
+	catch (const runtime_error& e)
+	{
+		cout << e.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}